@@ -0,0 +1,65 @@
+#pragma once
+#include "vector.h"
+
+#include <cstddef>
+#include <limits>
+#include <new>
+
+// Аллокатор, выравнивающий каждый блок по границе Alignment байт (кеш-линии или SIMD-регистра).
+// При PadToAlignment размер блока округляется вверх до целого числа выравниваний, и вектор получает
+// вместимость, кратную числу SIMD-полос, так что обработка хвоста не требует маски
+template <typename T, size_t Alignment, bool PadToAlignment = false>
+class AlignedAllocator {
+    static_assert(Alignment != 0 && (Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+    static_assert(Alignment >= alignof(T), "Alignment must not be weaker than alignof(T)");
+
+public:
+    using value_type = T;
+
+    static constexpr size_t ALIGNMENT = Alignment;
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment, PadToAlignment>;
+    };
+
+    AlignedAllocator() = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment, PadToAlignment>&) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        return allocate_at_least(n).ptr;
+    }
+
+    AllocationResult<T> allocate_at_least(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T) - Alignment) {
+            VECTOR_THROW(std::bad_array_new_length());
+        }
+        size_t bytes = n * sizeof(T);
+        if constexpr (PadToAlignment) {
+            bytes = (bytes + Alignment - 1) / Alignment * Alignment;
+        }
+        void* ptr = ::operator new(bytes, std::align_val_t{Alignment});
+        return {static_cast<T*>(ptr), bytes / sizeof(T)};
+    }
+
+    void deallocate(T* ptr, size_t /*n*/) noexcept {
+        ::operator delete(ptr, std::align_val_t{Alignment});
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment, PadToAlignment>&) const noexcept {
+        return true;
+    }
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment, PadToAlignment>&) const noexcept {
+        return false;
+    }
+};
+
+// Вектор, данные которого при любой реаллокации выровнены по Alignment байт,
+// а вместимость кратна Alignment / sizeof(T) элементам
+template <typename T, size_t Alignment = 64, typename GrowthPolicy = DoublingGrowth, typename Stats = NoStats>
+using AlignedVector = Vector<T, AlignedAllocator<T, Alignment, true>, GrowthPolicy, Stats>;
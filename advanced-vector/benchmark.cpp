@@ -0,0 +1,359 @@
+// Микробенчмарки Vector в сравнении с std::vector.
+// Сборка: g++ -std=c++17 -O2 -DNDEBUG benchmark.cpp -o benchmark
+// Запуск: ./benchmark [--filter=<подстрока>] [--max-bytes=<байт>] [--min-time=<мс>]
+#include "vector.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+// Счётчик обращений к глобальному operator new, чтобы сравнивать число выделений памяти
+size_t num_allocations = 0;
+
+}  // namespace
+
+// Замещающие операторы не встраиваются, иначе GCC ошибочно сопоставляет free с new в точке вызова
+[[gnu::noinline]] void* operator new(size_t size) {
+    ++num_allocations;
+    if (void* ptr = std::malloc(size != 0 ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+[[gnu::noinline]] void operator delete(void* ptr, size_t /*size*/) noexcept {
+    std::free(ptr);
+}
+
+namespace {
+
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Тривиально копируемый элемент размером Size байт
+template <size_t Size>
+struct Pod {
+    Pod() = default;
+    explicit Pod(size_t value) noexcept {
+        bytes[0] = static_cast<unsigned char>(value);
+    }
+    unsigned char bytes[Size] = {};
+};
+
+// Элемент размером Size байт с пользовательскими конструктором перемещения и деструктором
+template <size_t Size>
+struct NonTrivial {
+    NonTrivial() = default;
+    explicit NonTrivial(size_t value) noexcept {
+        bytes[0] = static_cast<unsigned char>(value);
+    }
+    NonTrivial(const NonTrivial& other) noexcept {
+        Copy(other);
+    }
+    NonTrivial(NonTrivial&& other) noexcept {
+        Copy(other);
+    }
+    NonTrivial& operator=(const NonTrivial& other) noexcept {
+        Copy(other);
+        return *this;
+    }
+    NonTrivial& operator=(NonTrivial&& other) noexcept {
+        Copy(other);
+        return *this;
+    }
+    ~NonTrivial() {
+        DoNotOptimize(bytes[0]);
+    }
+
+    void Copy(const NonTrivial& other) noexcept {
+        for (size_t i = 0; i != Size; ++i) {
+            bytes[i] = other.bytes[i];
+        }
+    }
+
+    unsigned char bytes[Size] = {};
+};
+
+// Единый интерфейс к std::vector и Vector
+template <typename T>
+void PushBack(std::vector<T>& v, const T& value) {
+    v.push_back(value);
+}
+template <typename T>
+void PushBack(Vector<T>& v, const T& value) {
+    v.PushBack(value);
+}
+
+template <typename T>
+void EmplaceBack(std::vector<T>& v, size_t value) {
+    v.emplace_back(value);
+}
+template <typename T>
+void EmplaceBack(Vector<T>& v, size_t value) {
+    v.EmplaceBack(value);
+}
+
+template <typename T>
+void Reserve(std::vector<T>& v, size_t capacity) {
+    v.reserve(capacity);
+}
+template <typename T>
+void Reserve(Vector<T>& v, size_t capacity) {
+    v.Reserve(capacity);
+}
+
+template <typename T>
+void InsertMiddle(std::vector<T>& v, const T& value) {
+    v.insert(v.begin() + v.size() / 2, value);
+}
+template <typename T>
+void InsertMiddle(Vector<T>& v, const T& value) {
+    v.Insert(v.cbegin() + v.Size() / 2, value);
+}
+
+template <typename T>
+void EraseMiddle(std::vector<T>& v) {
+    v.erase(v.begin() + v.size() / 2);
+}
+template <typename T>
+void EraseMiddle(Vector<T>& v) {
+    v.Erase(v.cbegin() + v.Size() / 2);
+}
+
+template <typename T>
+size_t GetSize(const std::vector<T>& v) {
+    return v.size();
+}
+template <typename T>
+size_t GetSize(const Vector<T>& v) {
+    return v.Size();
+}
+
+template <typename Container>
+Container MakeFilled(size_t size) {
+    Container v(size);
+    return v;
+}
+
+// Операции над контейнером. Каждая возвращает число выполненных элементарных операций
+template <typename Container, typename T>
+size_t RunPushBack(size_t size) {
+    Container v;
+    const T value(1);
+    for (size_t i = 0; i != size; ++i) {
+        PushBack(v, value);
+    }
+    DoNotOptimize(v);
+    return size;
+}
+
+template <typename Container, typename T>
+size_t RunEmplaceBack(size_t size) {
+    Container v;
+    for (size_t i = 0; i != size; ++i) {
+        EmplaceBack(v, i);
+    }
+    DoNotOptimize(v);
+    return size;
+}
+
+// Рост через последовательные Reserve с удвоением ёмкости
+template <typename Container, typename T>
+size_t RunReserveGrow(size_t size) {
+    Container v = MakeFilled<Container>(size / 2);
+    size_t operations = 0;
+    for (size_t capacity = size; capacity <= size * 8; capacity *= 2) {
+        Reserve(v, capacity);
+        ++operations;
+    }
+    DoNotOptimize(v);
+    return operations;
+}
+
+inline constexpr size_t MIDDLE_OPERATIONS = 64;
+
+template <typename Container, typename T>
+size_t RunInsertMiddle(size_t size) {
+    Container v = MakeFilled<Container>(size);
+    Reserve(v, size + MIDDLE_OPERATIONS);
+    const T value(1);
+    for (size_t i = 0; i != MIDDLE_OPERATIONS; ++i) {
+        InsertMiddle(v, value);
+    }
+    DoNotOptimize(v);
+    return MIDDLE_OPERATIONS;
+}
+
+template <typename Container, typename T>
+size_t RunEraseMiddle(size_t size) {
+    Container v = MakeFilled<Container>(size + MIDDLE_OPERATIONS);
+    for (size_t i = 0; i != MIDDLE_OPERATIONS; ++i) {
+        EraseMiddle(v);
+    }
+    DoNotOptimize(v);
+    return MIDDLE_OPERATIONS;
+}
+
+template <typename Container, typename T>
+size_t RunCopyAssign(size_t size) {
+    const Container source = MakeFilled<Container>(size);
+    Container target = MakeFilled<Container>(size);
+    const size_t repetitions = 4;
+    for (size_t i = 0; i != repetitions; ++i) {
+        target = source;
+        DoNotOptimize(target);
+    }
+    return repetitions * size;
+}
+
+template <typename Container, typename T>
+size_t RunIterate(size_t size) {
+    const Container v = MakeFilled<Container>(size);
+    const size_t repetitions = 4;
+    size_t sum = 0;
+    for (size_t i = 0; i != repetitions; ++i) {
+        for (const T& item : v) {
+            sum += item.bytes[0];
+        }
+        DoNotOptimize(sum);
+    }
+    return repetitions * size;
+}
+
+struct Measurement {
+    double ns_per_operation = 0;
+    double allocations_per_run = 0;
+};
+
+struct Options {
+    std::string_view filter;
+    size_t max_bytes = size_t{2} << 30;
+    double min_time_ms = 100;
+};
+
+// Повторяет run, пока суммарное время не превысит min_time_ms
+template <typename Run>
+Measurement Measure(Run run, size_t size, const Options& options) {
+    using Clock = std::chrono::steady_clock;
+    size_t operations = 0;
+    size_t runs = 0;
+    const size_t old_num_allocations = num_allocations;
+    const Clock::time_point start = Clock::now();
+    Clock::duration elapsed{};
+    do {
+        operations += run(size);
+        ++runs;
+        elapsed = Clock::now() - start;
+    } while (std::chrono::duration<double, std::milli>(elapsed).count() < options.min_time_ms);
+    Measurement result;
+    result.ns_per_operation = std::chrono::duration<double, std::nano>(elapsed).count() / operations;
+    result.allocations_per_run = static_cast<double>(num_allocations - old_num_allocations) / runs;
+    return result;
+}
+
+void PrintHeader() {
+    using namespace std;
+    cout << left << setw(14) << "operation"sv << setw(18) << "element"sv << right << setw(11) << "size"sv
+         << setw(16) << "std::vector ns"sv << setw(12) << "Vector ns"sv << setw(8) << "ratio"sv
+         << setw(12) << "std allocs"sv << setw(12) << "allocs"sv << endl;
+}
+
+template <typename T, template <typename, typename> typename Run>
+void Compare(std::string_view operation, std::string_view element, size_t size, size_t max_size,
+             const Options& options) {
+    using namespace std;
+    const string name = string(operation) + "/" + string(element) + "/" + to_string(size);
+    if (name.find(options.filter) == string::npos || size > max_size || size * sizeof(T) > options.max_bytes) {
+        return;
+    }
+    const Measurement std_result = Measure(Run<std::vector<T>, T>::Call, size, options);
+    const Measurement result = Measure(Run<Vector<T>, T>::Call, size, options);
+    cout << left << setw(14) << operation << setw(18) << element << right << setw(11) << size << fixed
+         << setprecision(3) << setw(16) << std_result.ns_per_operation << setw(12) << result.ns_per_operation
+         << setprecision(2) << setw(8) << result.ns_per_operation / std_result.ns_per_operation << setprecision(1)
+         << setw(12) << std_result.allocations_per_run << setw(12) << result.allocations_per_run << endl;
+}
+
+#define DEFINE_RUN(Name)                              \
+    template <typename Container, typename T>         \
+    struct Name##Op {                                 \
+        static size_t Call(size_t size) {             \
+            return Run##Name<Container, T>(size);     \
+        }                                             \
+    };
+
+DEFINE_RUN(PushBack)
+DEFINE_RUN(EmplaceBack)
+DEFINE_RUN(ReserveGrow)
+DEFINE_RUN(InsertMiddle)
+DEFINE_RUN(EraseMiddle)
+DEFINE_RUN(CopyAssign)
+DEFINE_RUN(Iterate)
+
+#undef DEFINE_RUN
+
+inline constexpr size_t SIZES[] = {10, 1'000, 100'000, 10'000'000, 100'000'000};
+// Вставка и удаление в середине выполняются за линейное время, поэтому размеры ограничены
+inline constexpr size_t MAX_MIDDLE_SIZE = 1'000'000;
+inline constexpr size_t MAX_SIZE = 100'000'000;
+
+template <typename T>
+void RunAll(std::string_view element, const Options& options) {
+    for (size_t size : SIZES) {
+        Compare<T, PushBackOp>("PushBack", element, size, MAX_SIZE, options);
+        Compare<T, EmplaceBackOp>("EmplaceBack", element, size, MAX_SIZE, options);
+        Compare<T, ReserveGrowOp>("ReserveGrow", element, size, MAX_SIZE / 8, options);
+        Compare<T, InsertMiddleOp>("InsertMiddle", element, size, MAX_MIDDLE_SIZE, options);
+        Compare<T, EraseMiddleOp>("EraseMiddle", element, size, MAX_MIDDLE_SIZE, options);
+        Compare<T, CopyAssignOp>("CopyAssign", element, size, MAX_SIZE, options);
+        Compare<T, IterateOp>("Iterate", element, size, MAX_SIZE, options);
+    }
+}
+
+Options ParseOptions(int argc, char** argv) {
+    using namespace std::literals;
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg.substr(0, "--filter="sv.size()) == "--filter="sv) {
+            options.filter = arg.substr("--filter="sv.size());
+        } else if (arg.substr(0, "--max-bytes="sv.size()) == "--max-bytes="sv) {
+            options.max_bytes = std::stoull(std::string(arg.substr("--max-bytes="sv.size())));
+        } else if (arg.substr(0, "--min-time="sv.size()) == "--min-time="sv) {
+            options.min_time_ms = std::stod(std::string(arg.substr("--min-time="sv.size())));
+        } else {
+            std::cerr << "Unknown option: "sv << arg << std::endl;
+            std::exit(1);
+        }
+    }
+    return options;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const Options options = ParseOptions(argc, argv);
+    PrintHeader();
+    RunAll<Pod<1>>("Pod<1>", options);
+    RunAll<Pod<8>>("Pod<8>", options);
+    RunAll<Pod<16>>("Pod<16>", options);
+    RunAll<Pod<64>>("Pod<64>", options);
+    RunAll<Pod<256>>("Pod<256>", options);
+    RunAll<NonTrivial<8>>("NonTrivial<8>", options);
+    RunAll<NonTrivial<64>>("NonTrivial<64>", options);
+    RunAll<NonTrivial<256>>("NonTrivial<256>", options);
+}
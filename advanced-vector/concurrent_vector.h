@@ -0,0 +1,253 @@
+#pragma once
+#include "vector.h"
+
+#include <atomic>
+#include <cassert>
+#include <climits>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+// Вектор, в который несколько потоков могут одновременно добавлять элементы без мьютексов.
+// Элементы хранятся в сегментах RawMemory, размеры которых растут геометрически
+// (FirstSegmentSize, 2 * FirstSegmentSize, ...). Сегменты никогда не перемещаются, поэтому ссылки
+// на элементы остаются действительными до уничтожения вектора.
+// EmplaceBack атомарно занимает индекс и создаёт элемент, после чего публикует его, и никогда
+// не ждёт другие потоки. Отсутствующий сегмент публикуется сравнением с обменом, а проигравший
+// поток освобождает свой. Поток, занявший первый индекс сегмента, заранее выделяет следующий,
+// поэтому к границе сегмента остальные потоки обычно подходят, когда он уже опубликован, и большие
+// поздние сегменты почти никогда не выделяются лишний раз. Сегменты, их флаги публикации
+// и элементы размещаются через Allocator.
+// Читать элемент из другого потока можно только после его публикации (IsPublished или TryGet).
+// Clear и деструктор не должны выполняться одновременно с другими операциями
+template <typename T, typename Allocator = std::allocator<T>, size_t FirstSegmentSize = 32>
+class ConcurrentVector {
+    static_assert(FirstSegmentSize != 0 && (FirstSegmentSize & (FirstSegmentSize - 1)) == 0,
+                  "First segment size must be a power of two");
+
+public:
+    using allocator_type = Allocator;
+
+    ConcurrentVector() = default;
+
+    explicit ConcurrentVector(const Allocator& alloc) noexcept
+        : alloc_(alloc) {
+    }
+
+    ConcurrentVector(const ConcurrentVector&) = delete;
+    ConcurrentVector& operator=(const ConcurrentVector&) = delete;
+
+    ~ConcurrentVector() {
+        Clear();
+        for (std::atomic<Segment*>& segment : segments_) {
+            if (Segment* ptr = segment.load(std::memory_order_relaxed)) {
+                DestroySegment(ptr);
+            }
+        }
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        const size_t index = claimed_.fetch_add(1, std::memory_order_relaxed);
+        const Location location = Locate(index);
+        Segment& segment = GetOrCreateSegment(location.segment);
+        if (location.offset == 0 && location.segment + 1 != MAX_SEGMENTS) {
+            GetOrCreateSegment(location.segment + 1);
+        }
+        T* slot = new (segment.elements.GetAddress() + location.offset) T(std::forward<Args>(args)...);
+        segment.published[location.offset].store(true, std::memory_order_release);
+        return *slot;
+    }
+
+    T& PushBack(const T& value) {
+        return EmplaceBack(value);
+    }
+
+    T& PushBack(T&& value) {
+        return EmplaceBack(std::move(value));
+    }
+
+    // Число занятых индексов. Элементы с индексами меньше Size() могут ещё создаваться,
+    // а если конструктор выбросил исключение, индекс так и останется неопубликованным
+    size_t Size() const noexcept {
+        return claimed_.load(std::memory_order_acquire);
+    }
+
+    // Проверяет, что элемент с индексом index создан и виден текущему потоку
+    bool IsPublished(size_t index) const noexcept {
+        if (index >= Size()) {
+            return false;
+        }
+        const Location location = Locate(index);
+        const Segment* segment = segments_[location.segment].load(std::memory_order_acquire);
+        return segment != nullptr && segment->published[location.offset].load(std::memory_order_acquire);
+    }
+
+    // Возвращает адрес опубликованного элемента или nullptr
+    const T* TryGet(size_t index) const noexcept {
+        return IsPublished(index) ? &GetElement(index) : nullptr;
+    }
+
+    T* TryGet(size_t index) noexcept {
+        return const_cast<T*>(std::as_const(*this).TryGet(index));
+    }
+
+    // Элемент должен быть опубликован
+    const T& operator[](size_t index) const noexcept {
+        assert(IsPublished(index));
+        return GetElement(index);
+    }
+
+    T& operator[](size_t index) noexcept {
+        return const_cast<T&>(std::as_const(*this)[index]);
+    }
+
+    // Заранее выделяет сегменты, в которых поместятся capacity элементов
+    void Reserve(size_t capacity) {
+        if (capacity == 0) {
+            return;
+        }
+        const size_t last_segment = Locate(capacity - 1).segment;
+        for (size_t segment = 0; segment <= last_segment; ++segment) {
+            GetOrCreateSegment(segment);
+        }
+    }
+
+    // Вместимость выделенных сегментов. Сегменты выделяются по порядку индексов лишь приблизительно,
+    // поэтому учитывается только непрерывная последовательность сегментов с начала
+    size_t Capacity() const noexcept {
+        size_t capacity = 0;
+        for (size_t segment = 0; segment != MAX_SEGMENTS; ++segment) {
+            if (segments_[segment].load(std::memory_order_acquire) == nullptr) {
+                break;
+            }
+            capacity += GetSegmentSize(segment);
+        }
+        return capacity;
+    }
+
+    // Вызывает f для каждого опубликованного элемента в порядке индексов
+    template <typename F>
+    void ForEach(F f) const {
+        const size_t size = Size();
+        for (size_t index = 0; index != size; ++index) {
+            if (const T* element = TryGet(index)) {
+                f(*element);
+            }
+        }
+    }
+
+    // Уничтожает опубликованные элементы, сохраняя сегменты
+    void Clear() noexcept {
+        const size_t size = claimed_.load(std::memory_order_relaxed);
+        for (size_t index = 0; index != size; ++index) {
+            const Location location = Locate(index);
+            Segment* segment = segments_[location.segment].load(std::memory_order_relaxed);
+            if (segment != nullptr && segment->published[location.offset].load(std::memory_order_relaxed)) {
+                segment->elements.GetAddress()[location.offset].~T();
+                segment->published[location.offset].store(false, std::memory_order_relaxed);
+            }
+        }
+        claimed_.store(0, std::memory_order_relaxed);
+    }
+
+    const Allocator& GetAllocator() const noexcept {
+        return alloc_;
+    }
+
+private:
+    static constexpr size_t Log2(size_t value) noexcept {
+        size_t result = 0;
+        while (value >>= 1) {
+            ++result;
+        }
+        return result;
+    }
+
+    static constexpr size_t FIRST_SEGMENT_LOG = Log2(FirstSegmentSize);
+    static constexpr size_t MAX_SEGMENTS = sizeof(size_t) * CHAR_BIT - FIRST_SEGMENT_LOG;
+
+    using AllocTraits = std::allocator_traits<Allocator>;
+    using FlagAllocator = typename AllocTraits::template rebind_alloc<std::atomic<bool>>;
+
+    struct Segment {
+        Segment(size_t size, const Allocator& alloc)
+            : elements(size, alloc)
+            , published(size, FlagAllocator(alloc)) {
+            std::uninitialized_value_construct_n(published.GetAddress(), size);
+        }
+
+        RawMemory<T, Allocator> elements;
+        RawMemory<std::atomic<bool>, FlagAllocator> published;
+    };
+
+    using SegmentAllocator = typename AllocTraits::template rebind_alloc<Segment>;
+    using SegmentTraits = std::allocator_traits<SegmentAllocator>;
+
+    struct Location {
+        size_t segment;
+        size_t offset;
+    };
+
+    static size_t GetSegmentSize(size_t segment) noexcept {
+        return FirstSegmentSize << segment;
+    }
+
+    // Сегмент k начинается с индекса FirstSegmentSize * (2^k - 1)
+    static Location Locate(size_t index) noexcept {
+        const size_t shifted = index + FirstSegmentSize;
+#if defined(__GNUC__)
+        const size_t log = sizeof(unsigned long long) * CHAR_BIT - 1 - __builtin_clzll(shifted);
+#else
+        const size_t log = Log2(shifted);
+#endif
+        const size_t segment = log - FIRST_SEGMENT_LOG;
+        return {segment, shifted - (size_t{1} << log)};
+    }
+
+    const T& GetElement(size_t index) const noexcept {
+        const Location location = Locate(index);
+        return segments_[location.segment].load(std::memory_order_acquire)->elements.GetAddress()[location.offset];
+    }
+
+    Segment& GetOrCreateSegment(size_t index) {
+        if (index >= MAX_SEGMENTS) {
+            VECTOR_THROW(std::length_error("ConcurrentVector is too long"));
+        }
+        std::atomic<Segment*>& slot = segments_[index];
+        Segment* segment = slot.load(std::memory_order_acquire);
+        if (segment != nullptr) {
+            return *segment;
+        }
+        Segment* created = CreateSegment(GetSegmentSize(index));
+        if (slot.compare_exchange_strong(segment, created, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            return *created;
+        }
+        // Сегмент уже опубликовал другой поток
+        DestroySegment(created);
+        return *segment;
+    }
+
+    Segment* CreateSegment(size_t size) {
+        SegmentAllocator alloc(alloc_);
+        Segment* segment = SegmentTraits::allocate(alloc, 1);
+        VECTOR_TRY {
+            SegmentTraits::construct(alloc, segment, size, alloc_);
+        } VECTOR_CATCH_ALL {
+            SegmentTraits::deallocate(alloc, segment, 1);
+            VECTOR_RETHROW;
+        }
+        return segment;
+    }
+
+    void DestroySegment(Segment* segment) noexcept {
+        SegmentAllocator alloc(alloc_);
+        SegmentTraits::destroy(alloc, segment);
+        SegmentTraits::deallocate(alloc, segment, 1);
+    }
+
+    [[no_unique_address]] Allocator alloc_;
+    std::atomic<size_t> claimed_{0};
+    std::atomic<Segment*> segments_[MAX_SEGMENTS] = {};
+};
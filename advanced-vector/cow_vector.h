@@ -0,0 +1,262 @@
+#pragma once
+#include "vector.h"
+
+#include <atomic>
+#include <cassert>
+#include <initializer_list>
+#include <memory>
+#include <utility>
+
+// Вектор с копированием при записи. Копии разделяют один блок с атомарным счётчиком ссылок,
+// поэтому копирование стоит одного атомарного инкремента, а чтение — обычного разыменования
+// указателя. Первая изменяющая операция над разделяемым блоком отделяет копию одним проходом
+// копирования элементов. Разные объекты CowVector можно использовать из разных потоков,
+// даже если они разделяют блок; один объект — как и Vector — требует внешней синхронизации.
+// Блок размещается аллокатором своих элементов
+template <typename T, typename Allocator = std::allocator<T>, typename GrowthPolicy = DoublingGrowth>
+class CowVector {
+public:
+    using allocator_type = Allocator;
+    using container_type = Vector<T, Allocator, GrowthPolicy>;
+    using iterator = const T*;
+    using const_iterator = const T*;
+
+    CowVector() = default;
+
+    explicit CowVector(container_type elements)
+        : block_(CreateBlock(std::move(elements))) {
+    }
+
+    CowVector(std::initializer_list<T> values) {
+        container_type elements;
+        elements.Append(values);
+        block_ = CreateBlock(std::move(elements));
+    }
+
+    CowVector(const CowVector& other) noexcept
+        : block_(other.block_) {
+        if (block_ != nullptr) {
+            block_->ref_count.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    CowVector(CowVector&& other) noexcept
+        : block_(std::exchange(other.block_, nullptr)) {
+    }
+
+    CowVector& operator=(const CowVector& rhs) noexcept {
+        CowVector rhs_copy(rhs);
+        Swap(rhs_copy);
+        return *this;
+    }
+
+    CowVector& operator=(CowVector&& rhs) noexcept {
+        if (this != &rhs) {
+            Release();
+            block_ = std::exchange(rhs.block_, nullptr);
+        }
+        return *this;
+    }
+
+    ~CowVector() {
+        Release();
+    }
+
+    void Swap(CowVector& other) noexcept {
+        std::swap(block_, other.block_);
+    }
+
+    const_iterator begin() const noexcept {
+        return Data();
+    }
+    const_iterator end() const noexcept {
+        return Data() + Size();
+    }
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    const T* Data() const noexcept {
+        return block_ == nullptr ? nullptr : block_->elements.Data();
+    }
+
+    size_t Size() const noexcept {
+        return block_ == nullptr ? 0 : block_->elements.Size();
+    }
+
+    size_t Capacity() const noexcept {
+        return block_ == nullptr ? 0 : block_->elements.Capacity();
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        assert(index < Size());
+        return block_->elements[index];
+    }
+
+    // Число объектов CowVector, разделяющих блок
+    size_t UseCount() const noexcept {
+        return block_ == nullptr ? 0 : block_->ref_count.load(std::memory_order_acquire);
+    }
+
+    bool IsShared() const noexcept {
+        return UseCount() > 1;
+    }
+
+    // Возвращает единолично принадлежащие объекту элементы, при необходимости отделяя копию.
+    // Ссылка действительна до ближайшего копирования или уничтожения объекта: изменения через неё
+    // после копирования стали бы видны другим копиям
+    container_type& Edit() {
+        Release(Detach(Size()));
+        return block_->elements;
+    }
+
+    T& GetMutable(size_t index) {
+        assert(index < Size());
+        return Edit()[index];
+    }
+
+    T* MutableData() {
+        return Edit().Data();
+    }
+
+    void Reserve(size_t new_capacity) {
+        Release(Detach(new_capacity));
+        block_->elements.Reserve(new_capacity);
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        // Отделённая копия сразу получает место под новый элемент, чтобы не реаллоцировать её повторно.
+        // Аргументы могут ссылаться на элементы прежнего блока, поэтому он отпускается после вставки
+        const SharedBlock shared{Detach(GrowthPolicy::template NextCapacity<T>(Size(), Size() + 1))};
+        return block_->elements.EmplaceBack(std::forward<Args>(args)...);
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    void PopBack() {
+        assert(Size() != 0);
+        Edit().PopBack();
+    }
+
+    void Resize(size_t new_size) {
+        Release(Detach(new_size));
+        block_->elements.Resize(new_size);
+    }
+
+    const_iterator Erase(const_iterator pos) {
+        const size_t offset = pos - begin();
+        container_type& elements = Edit();
+        return elements.Erase(elements.begin() + offset);
+    }
+
+    const_iterator Erase(const_iterator first, const_iterator last) {
+        const size_t offset = first - begin();
+        const size_t count = last - first;
+        container_type& elements = Edit();
+        return elements.Erase(elements.begin() + offset, elements.begin() + offset + count);
+    }
+
+    template <typename... Args>
+    const_iterator Emplace(const_iterator pos, Args&&... args) {
+        const size_t offset = pos - begin();
+        const SharedBlock shared{Detach(GrowthPolicy::template NextCapacity<T>(Size(), Size() + 1))};
+        return block_->elements.Emplace(block_->elements.begin() + offset, std::forward<Args>(args)...);
+    }
+
+    const_iterator Insert(const_iterator pos, const T& value) {
+        return Emplace(pos, value);
+    }
+
+    const_iterator Insert(const_iterator pos, T&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    // Разделяемый блок не копируется, а просто отпускается
+    void Clear() noexcept {
+        if (IsShared()) {
+            Release();
+            block_ = nullptr;
+        } else if (block_ != nullptr) {
+            block_->elements.Clear();
+        }
+    }
+
+private:
+    struct Block {
+        explicit Block(container_type values)
+            : elements(std::move(values)) {
+        }
+
+        std::atomic<size_t> ref_count{1};
+        container_type elements;
+    };
+
+    using BlockAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Block>;
+    using BlockTraits = std::allocator_traits<BlockAllocator>;
+
+    // Ссылка на прежний блок, отпускаемая при выходе из области видимости
+    struct SharedBlock {
+        ~SharedBlock() {
+            Release(block);
+        }
+
+        Block* block;
+    };
+
+    // Делает блок единолично принадлежащим объекту. Разделяемые элементы копируются одним проходом
+    // в буфер вместимостью не меньше min_capacity. Возвращает прежний разделяемый блок или nullptr;
+    // вызывающий отпускает его, когда аргументы операции больше не могут ссылаться на его элементы
+    [[nodiscard]] Block* Detach(size_t min_capacity) {
+        if (block_ == nullptr) {
+            block_ = CreateBlock(container_type());
+            return nullptr;
+        }
+        if (block_->ref_count.load(std::memory_order_acquire) == 1) {
+            return nullptr;
+        }
+        container_type copy(block_->elements.GetAllocator());
+        copy.Reserve(std::max(min_capacity, Size()));
+        copy.Append(block_->elements.begin(), block_->elements.end());
+        return std::exchange(block_, CreateBlock(std::move(copy)));
+    }
+
+    void Release() noexcept {
+        Release(block_);
+    }
+
+    static void Release(Block* block) noexcept {
+        if (block != nullptr && block->ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            DestroyBlock(block);
+        }
+    }
+
+    static Block* CreateBlock(container_type elements) {
+        BlockAllocator alloc(elements.GetAllocator());
+        Block* block = BlockTraits::allocate(alloc, 1);
+        VECTOR_TRY {
+            BlockTraits::construct(alloc, block, std::move(elements));
+        } VECTOR_CATCH_ALL {
+            BlockTraits::deallocate(alloc, block, 1);
+            VECTOR_RETHROW;
+        }
+        return block;
+    }
+
+    static void DestroyBlock(Block* block) noexcept {
+        BlockAllocator alloc(block->elements.GetAllocator());
+        BlockTraits::destroy(alloc, block);
+        BlockTraits::deallocate(alloc, block, 1);
+    }
+
+    Block* block_ = nullptr;
+};
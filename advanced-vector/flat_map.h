@@ -0,0 +1,266 @@
+#pragma once
+#include "flat_set.h"
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <initializer_list>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+// Упорядоченный ассоциативный массив, хранящий пары ключ-значение в отсортированном Vector.
+// Устроен так же, как FlatSet. Итераторы позволяют изменять пары, но менять ключ нельзя:
+// это нарушит порядок. Любая вставка и удаление делают итераторы недействительными
+template <typename Key, typename Value, typename Compare = std::less<Key>, typename Search = BranchlessSearch,
+          typename Allocator = std::allocator<std::pair<Key, Value>>>
+class FlatMap {
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair<Key, Value>;
+    using key_compare = Compare;
+    using allocator_type = Allocator;
+    using container_type = Vector<value_type, Allocator>;
+    using iterator = value_type*;
+    using const_iterator = const value_type*;
+
+    FlatMap() = default;
+
+    explicit FlatMap(const Compare& comp, const Allocator& alloc = Allocator())
+        : items_(alloc)
+        , comp_{comp} {
+    }
+
+    template <typename InputIt, typename = detail::RequireInputIterator<InputIt>>
+    FlatMap(InputIt first, InputIt last, const Compare& comp = Compare(), const Allocator& alloc = Allocator())
+        : FlatMap(comp, alloc) {
+        Insert(first, last);
+    }
+
+    FlatMap(std::initializer_list<value_type> items, const Compare& comp = Compare(),
+            const Allocator& alloc = Allocator())
+        : FlatMap(items.begin(), items.end(), comp, alloc) {
+    }
+
+    // items должны быть отсортированы по ключу и не содержать повторов
+    FlatMap(SortedUniqueTag, container_type items, const Compare& comp = Compare())
+        : items_(std::move(items))
+        , comp_{comp} {
+        assert(detail::IsSortedUnique(items_, comp_));
+    }
+
+    template <typename InputIt, typename = detail::RequireInputIterator<InputIt>>
+    FlatMap(SortedUniqueTag, InputIt first, InputIt last, const Compare& comp = Compare(),
+            const Allocator& alloc = Allocator())
+        : FlatMap(comp, alloc) {
+        items_.Append(first, last);
+        assert(detail::IsSortedUnique(items_, comp_));
+    }
+
+    iterator begin() noexcept {
+        return items_.begin();
+    }
+    iterator end() noexcept {
+        return items_.end();
+    }
+    const_iterator begin() const noexcept {
+        return items_.begin();
+    }
+    const_iterator end() const noexcept {
+        return items_.end();
+    }
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    size_t Size() const noexcept {
+        return items_.Size();
+    }
+
+    size_t Capacity() const noexcept {
+        return items_.Capacity();
+    }
+
+    void Reserve(size_t new_capacity) {
+        items_.Reserve(new_capacity);
+    }
+
+    void ShrinkToFit() {
+        items_.ShrinkToFit();
+    }
+
+    void Clear() noexcept {
+        items_.Clear();
+    }
+
+    void Swap(FlatMap& other) noexcept {
+        items_.Swap(other.items_);
+        std::swap(comp_, other.comp_);
+    }
+
+    const_iterator LowerBound(const Key& key) const {
+        return Search::LowerBound(items_.Data(), items_.Size(), key, comp_);
+    }
+
+    iterator LowerBound(const Key& key) {
+        return Search::LowerBound(items_.Data(), items_.Size(), key, comp_);
+    }
+
+    const_iterator UpperBound(const Key& key) const {
+        return std::upper_bound(begin(), end(), key, comp_);
+    }
+
+    iterator UpperBound(const Key& key) {
+        return std::upper_bound(begin(), end(), key, comp_);
+    }
+
+    const_iterator Find(const Key& key) const {
+        const const_iterator it = LowerBound(key);
+        return it != end() && !comp_(key, *it) ? it : end();
+    }
+
+    iterator Find(const Key& key) {
+        return const_cast<iterator>(std::as_const(*this).Find(key));
+    }
+
+    bool Contains(const Key& key) const {
+        return Find(key) != end();
+    }
+
+    size_t Count(const Key& key) const {
+        return Contains(key) ? 1 : 0;
+    }
+
+    const Value& At(const Key& key) const {
+        const const_iterator it = Find(key);
+        if (it == end()) {
+            VECTOR_THROW(std::out_of_range("FlatMap has no such key"));
+        }
+        return it->second;
+    }
+
+    Value& At(const Key& key) {
+        return const_cast<Value&>(std::as_const(*this).At(key));
+    }
+
+    // Добавляет значение по умолчанию, если ключа нет
+    Value& operator[](const Key& key) {
+        return TryEmplace(key).first->second;
+    }
+
+    Value& operator[](Key&& key) {
+        return TryEmplace(std::move(key)).first->second;
+    }
+
+    // Создаёт значение из args, только если ключа ещё нет. Возвращает позицию пары
+    // и признак того, что она была добавлена
+    template <typename K, typename... Args>
+    std::pair<iterator, bool> TryEmplace(K&& key, Args&&... args) {
+        const iterator it = LowerBound(key);
+        if (it != end() && !comp_(key, *it)) {
+            return {it, false};
+        }
+        return {items_.Emplace(it, std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)),
+                               std::forward_as_tuple(std::forward<Args>(args)...)),
+                true};
+    }
+
+    template <typename K, typename V>
+    std::pair<iterator, bool> InsertOrAssign(K&& key, V&& value) {
+        const auto [it, inserted] = TryEmplace(std::forward<K>(key), std::forward<V>(value));
+        if (!inserted) {
+            it->second = std::forward<V>(value);
+        }
+        return {it, inserted};
+    }
+
+    std::pair<iterator, bool> Insert(const value_type& item) {
+        return TryEmplace(item.first, item.second);
+    }
+
+    std::pair<iterator, bool> Insert(value_type&& item) {
+        return TryEmplace(std::move(item.first), std::move(item.second));
+    }
+
+    // Добавляет m пар пакетом за O(n + m log m). Значения существующих ключей не заменяются
+    template <typename InputIt, typename = detail::RequireInputIterator<InputIt>>
+    void Insert(InputIt first, InputIt last) {
+        const size_t old_size = items_.Size();
+        items_.Append(first, last);
+        detail::MergeSortedTail(items_, old_size, comp_, true);
+    }
+
+    void Insert(std::initializer_list<value_type> items) {
+        Insert(items.begin(), items.end());
+    }
+
+    // Добавляет пары, отсортированные по ключу без повторов, пропуская сортировку
+    template <typename InputIt, typename = detail::RequireInputIterator<InputIt>>
+    void Insert(SortedUniqueTag, InputIt first, InputIt last) {
+        const size_t old_size = items_.Size();
+        items_.Append(first, last);
+        assert(std::is_sorted(items_.begin() + old_size, items_.end(), comp_));
+        detail::MergeSortedTail(items_, old_size, comp_, false);
+    }
+
+    iterator Erase(const_iterator pos) {
+        return items_.Erase(pos);
+    }
+
+    iterator Erase(const_iterator first, const_iterator last) {
+        return items_.Erase(first, last);
+    }
+
+    size_t Erase(const Key& key) {
+        const const_iterator it = Find(key);
+        if (it == end()) {
+            return 0;
+        }
+        items_.Erase(it);
+        return 1;
+    }
+
+    // Отдаёт упорядоченные пары, оставляя массив пустым
+    container_type Extract() noexcept {
+        return std::move(items_);
+    }
+
+    const container_type& GetItems() const noexcept {
+        return items_;
+    }
+
+    const Compare& GetCompare() const noexcept {
+        return comp_.comp;
+    }
+
+    friend bool operator==(const FlatMap& lhs, const FlatMap& rhs) {
+        return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    friend bool operator!=(const FlatMap& lhs, const FlatMap& rhs) {
+        return !(lhs == rhs);
+    }
+
+private:
+    // Сравнивает пары и ключи по ключу
+    struct ItemCompare {
+        bool operator()(const value_type& lhs, const value_type& rhs) const {
+            return comp(lhs.first, rhs.first);
+        }
+        bool operator()(const value_type& lhs, const Key& rhs) const {
+            return comp(lhs.first, rhs);
+        }
+        bool operator()(const Key& lhs, const value_type& rhs) const {
+            return comp(lhs, rhs.first);
+        }
+
+        [[no_unique_address]] Compare comp;
+    };
+
+    container_type items_;
+    ItemCompare comp_;
+};
@@ -0,0 +1,276 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <initializer_list>
+#include <utility>
+
+// Тег конструкторов и вставок FlatSet и FlatMap, принимающих данные, уже отсортированные без повторов
+struct SortedUniqueTag {
+    explicit SortedUniqueTag() = default;
+};
+
+inline constexpr SortedUniqueTag SORTED_UNIQUE{};
+
+// Политики поиска FlatSet и FlatMap. LowerBound(first, size, key, comp) возвращает адрес первого
+// элемента x, для которого comp(x, key) ложно, или first + size
+
+// Обычный двоичный поиск
+struct BinarySearch {
+    template <typename T, typename Key, typename Compare>
+    static T* LowerBound(T* first, size_t size, const Key& key, const Compare& comp) {
+        return std::lower_bound(first, first + size, key, comp);
+    }
+};
+
+// Двоичный поиск без ветвлений: на каждом шаге половина диапазона отбрасывается условным
+// присваиванием, которое компилируется в cmov. Число сравнений зависит только от размера,
+// поэтому процессору нечего предсказывать
+struct BranchlessSearch {
+    template <typename T, typename Key, typename Compare>
+    static T* LowerBound(T* first, size_t size, const Key& key, const Compare& comp) {
+        if (size == 0) {
+            return first;
+        }
+        while (size > 1) {
+            const size_t half = size / 2;
+            first = comp(first[half], key) ? first + half : first;
+            size -= half;
+        }
+        return first + (comp(*first, key) ? 1 : 0);
+    }
+};
+
+namespace detail {
+
+// Упорядочивает добавленные в конец keys элементы, начиная с old_size (сортируя их, если
+// sort_tail), сливает их с уже упорядоченной частью и удаляет повторы. Из равных элементов
+// остаётся первый, поэтому существующие элементы не заменяются новыми
+template <typename Container, typename Compare>
+void MergeSortedTail(Container& keys, size_t old_size, const Compare& comp, bool sort_tail) {
+    const auto middle = keys.begin() + old_size;
+    if (middle == keys.end()) {
+        return;
+    }
+    if (sort_tail) {
+        std::stable_sort(middle, keys.end(), comp);
+    }
+    // Если новые элементы больше старых, слияние не нужно и повторы возможны только в хвосте
+    auto unique_from = middle;
+    if (old_size != 0) {
+        --unique_from;
+        if (!comp(*unique_from, *middle)) {
+            std::inplace_merge(keys.begin(), middle, keys.end(), comp);
+            unique_from = keys.begin();
+        }
+    }
+    const auto first_duplicate = std::unique(unique_from, keys.end(), [&comp](const auto& lhs, const auto& rhs) {
+        return !comp(lhs, rhs);
+    });
+    keys.Erase(first_duplicate, keys.end());
+}
+
+template <typename Container, typename Compare>
+bool IsSortedUnique(const Container& keys, const Compare& comp) {
+    return std::adjacent_find(keys.begin(), keys.end(), [&comp](const auto& lhs, const auto& rhs) {
+        return !comp(lhs, rhs);
+    }) == keys.end();
+}
+
+}  // namespace detail
+
+// Упорядоченное множество, хранящее ключи в отсортированном Vector. Поиск выполняется
+// политикой Search по непрерывному массиву, вставка и удаление одиночного ключа сдвигают хвост.
+// Пакетная вставка добавляет ключи в конец одним Insert, после чего сортирует и сливает их
+// за один проход. Любая вставка и удаление делают итераторы недействительными
+template <typename Key, typename Compare = std::less<Key>, typename Search = BranchlessSearch,
+          typename Allocator = std::allocator<Key>>
+class FlatSet {
+public:
+    using key_type = Key;
+    using value_type = Key;
+    using key_compare = Compare;
+    using allocator_type = Allocator;
+    using container_type = Vector<Key, Allocator>;
+    using iterator = const Key*;
+    using const_iterator = const Key*;
+
+    FlatSet() = default;
+
+    explicit FlatSet(const Compare& comp, const Allocator& alloc = Allocator())
+        : keys_(alloc)
+        , comp_(comp) {
+    }
+
+    template <typename InputIt, typename = detail::RequireInputIterator<InputIt>>
+    FlatSet(InputIt first, InputIt last, const Compare& comp = Compare(), const Allocator& alloc = Allocator())
+        : FlatSet(comp, alloc) {
+        Insert(first, last);
+    }
+
+    FlatSet(std::initializer_list<Key> keys, const Compare& comp = Compare(), const Allocator& alloc = Allocator())
+        : FlatSet(keys.begin(), keys.end(), comp, alloc) {
+    }
+
+    // keys должны быть отсортированы по comp и не содержать повторов
+    FlatSet(SortedUniqueTag, container_type keys, const Compare& comp = Compare())
+        : keys_(std::move(keys))
+        , comp_(comp) {
+        assert(detail::IsSortedUnique(keys_, comp_));
+    }
+
+    template <typename InputIt, typename = detail::RequireInputIterator<InputIt>>
+    FlatSet(SortedUniqueTag, InputIt first, InputIt last, const Compare& comp = Compare(),
+            const Allocator& alloc = Allocator())
+        : FlatSet(comp, alloc) {
+        keys_.Append(first, last);
+        assert(detail::IsSortedUnique(keys_, comp_));
+    }
+
+    const_iterator begin() const noexcept {
+        return keys_.begin();
+    }
+    const_iterator end() const noexcept {
+        return keys_.end();
+    }
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    size_t Size() const noexcept {
+        return keys_.Size();
+    }
+
+    size_t Capacity() const noexcept {
+        return keys_.Capacity();
+    }
+
+    const Key& operator[](size_t index) const noexcept {
+        return keys_[index];
+    }
+
+    void Reserve(size_t new_capacity) {
+        keys_.Reserve(new_capacity);
+    }
+
+    void ShrinkToFit() {
+        keys_.ShrinkToFit();
+    }
+
+    void Clear() noexcept {
+        keys_.Clear();
+    }
+
+    void Swap(FlatSet& other) noexcept {
+        keys_.Swap(other.keys_);
+        std::swap(comp_, other.comp_);
+    }
+
+    const_iterator LowerBound(const Key& key) const {
+        return Search::LowerBound(keys_.Data(), keys_.Size(), key, comp_);
+    }
+
+    const_iterator UpperBound(const Key& key) const {
+        return std::upper_bound(begin(), end(), key, comp_);
+    }
+
+    const_iterator Find(const Key& key) const {
+        const const_iterator it = LowerBound(key);
+        return it != end() && !comp_(key, *it) ? it : end();
+    }
+
+    bool Contains(const Key& key) const {
+        return Find(key) != end();
+    }
+
+    size_t Count(const Key& key) const {
+        return Contains(key) ? 1 : 0;
+    }
+
+    // Возвращает позицию ключа и признак того, что он был добавлен
+    std::pair<iterator, bool> Insert(const Key& key) {
+        return Emplace(key);
+    }
+
+    std::pair<iterator, bool> Insert(Key&& key) {
+        return Emplace(std::move(key));
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> Emplace(Args&&... args) {
+        Key key(std::forward<Args>(args)...);
+        const const_iterator it = LowerBound(key);
+        if (it != end() && !comp_(key, *it)) {
+            return {it, false};
+        }
+        return {keys_.Insert(it, std::move(key)), true};
+    }
+
+    // Добавляет m ключей пакетом за O(n + m log m) вместо m сдвигов хвоста
+    template <typename InputIt, typename = detail::RequireInputIterator<InputIt>>
+    void Insert(InputIt first, InputIt last) {
+        const size_t old_size = keys_.Size();
+        keys_.Append(first, last);
+        detail::MergeSortedTail(keys_, old_size, comp_, true);
+    }
+
+    void Insert(std::initializer_list<Key> keys) {
+        Insert(keys.begin(), keys.end());
+    }
+
+    // Добавляет ключи, отсортированные без повторов, пропуская сортировку
+    template <typename InputIt, typename = detail::RequireInputIterator<InputIt>>
+    void Insert(SortedUniqueTag, InputIt first, InputIt last) {
+        const size_t old_size = keys_.Size();
+        keys_.Append(first, last);
+        assert(std::is_sorted(keys_.begin() + old_size, keys_.end(), comp_));
+        detail::MergeSortedTail(keys_, old_size, comp_, false);
+    }
+
+    iterator Erase(const_iterator pos) {
+        return keys_.Erase(pos);
+    }
+
+    iterator Erase(const_iterator first, const_iterator last) {
+        return keys_.Erase(first, last);
+    }
+
+    size_t Erase(const Key& key) {
+        const const_iterator it = Find(key);
+        if (it == end()) {
+            return 0;
+        }
+        keys_.Erase(it);
+        return 1;
+    }
+
+    // Отдаёт упорядоченные ключи, оставляя множество пустым
+    container_type Extract() noexcept {
+        return std::move(keys_);
+    }
+
+    const container_type& GetKeys() const noexcept {
+        return keys_;
+    }
+
+    const Compare& GetCompare() const noexcept {
+        return comp_;
+    }
+
+    friend bool operator==(const FlatSet& lhs, const FlatSet& rhs) {
+        return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    friend bool operator!=(const FlatSet& lhs, const FlatSet& rhs) {
+        return !(lhs == rhs);
+    }
+
+private:
+    container_type keys_;
+    [[no_unique_address]] Compare comp_;
+};
@@ -1,10 +1,38 @@
 #include "vector.h"
+#include "small_vector.h"
+#include "malloc_allocator.h"
+#include "aligned_allocator.h"
+#include "mmap_allocator.h"
+#include "mapped_vector.h"
+#include "concurrent_vector.h"
+#include "segmented_vector.h"
+#include "soa_vector.h"
+#include "flat_set.h"
+#include "flat_map.h"
+#include "ring_vector.h"
+#include "cow_vector.h"
+#include "static_vector.h"
+#include "vector_io.h"
+#include "vector_algorithms.h"
+#include "vector_stats.h"
 
 #include <iostream>
+#include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 #include <algorithm>
+#include <atomic>
+#include <numeric>
+
+#if VECTOR_DEBUG
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+#if VECTOR_ANNOTATE_CONTAINER
+#include <sanitizer/asan_interface.h>
+#endif
 
 namespace {
 
@@ -117,8 +145,168 @@ struct Obj {
     static inline int num_move_assigned = 0;
 };
 
+// Тип с нетривиальными конструктором перемещения и деструктором, явно помеченный
+// как тривиально перемещаемый
+struct RelocObj {
+    RelocObj() = default;
+    explicit RelocObj(int id)
+        : id(id) {
+    }
+    RelocObj(const RelocObj& other)
+        : id(other.id) {
+        ++num_copied;
+    }
+    RelocObj(RelocObj&& other) noexcept
+        : id(other.id) {
+        ++num_moved;
+    }
+    RelocObj& operator=(const RelocObj& other) = default;
+    RelocObj& operator=(RelocObj&& other) = default;
+    ~RelocObj() {
+        ++num_destroyed;
+    }
+
+    static void ResetCounters() {
+        num_copied = 0;
+        num_moved = 0;
+        num_destroyed = 0;
+    }
+
+    int id = 0;
+
+    static inline int num_copied = 0;
+    static inline int num_moved = 0;
+    static inline int num_destroyed = 0;
+};
+
+// Ресурс памяти, подсчитывающий число выделений и освобождений. Счётчики атомарны,
+// поэтому ресурсом могут пользоваться несколько потоков
+class CountingResource : public std::pmr::memory_resource {
+public:
+    std::atomic<int> num_allocated = 0;
+    std::atomic<int> num_deallocated = 0;
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        ++num_allocated;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        ++num_deallocated;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+// Аллокатор, выделяющий память последовательно из общего буфера. Последний выделенный блок
+// можно расширить на месте, пока в буфере есть место
+template <typename T>
+class BumpAllocator {
+public:
+    using value_type = T;
+
+    explicit BumpAllocator(std::byte* buffer, size_t size) noexcept
+        : buffer_(buffer)
+        , size_(size) {
+    }
+
+    template <typename U>
+    BumpAllocator(const BumpAllocator<U>& other) noexcept
+        : buffer_(other.buffer_)
+        , size_(other.size_) {
+    }
+
+    T* allocate(size_t n) {
+        last_ = buffer_ + used_;
+        used_ += n * sizeof(T);
+        if (used_ > size_) {
+            throw std::bad_alloc();
+        }
+        return reinterpret_cast<T*>(last_);
+    }
+
+    void deallocate(T*, size_t) noexcept {
+    }
+
+    size_t expand(T* ptr, size_t old_n, size_t n) noexcept {
+        if (reinterpret_cast<std::byte*>(ptr) != last_ || last_ + n * sizeof(T) > buffer_ + size_) {
+            return 0;
+        }
+        used_ += (n - old_n) * sizeof(T);
+        ++num_expanded;
+        return n;
+    }
+
+    bool operator==(const BumpAllocator& other) const noexcept {
+        return buffer_ == other.buffer_;
+    }
+    bool operator!=(const BumpAllocator& other) const noexcept {
+        return buffer_ != other.buffer_;
+    }
+
+    std::byte* buffer_;
+    size_t size_;
+    std::byte* last_ = nullptr;
+    size_t used_ = 0;
+    int num_expanded = 0;
+};
+
+// Перемещение может выбросить исключение, поэтому при реаллокации элементы копируются
+struct ThrowingMoveObj {
+    ThrowingMoveObj() = default;
+    ThrowingMoveObj(const ThrowingMoveObj&) = default;
+    ThrowingMoveObj(ThrowingMoveObj&&) noexcept(false) = default;
+    ThrowingMoveObj& operator=(const ThrowingMoveObj&) = default;
+    ThrowingMoveObj& operator=(ThrowingMoveObj&&) noexcept(false) = default;
+    ~ThrowingMoveObj() {
+    }
+    std::string value;
+};
+
+// Объект с атомарными счётчиками для проверки параллельных операций
+struct ConcurrentObj {
+    ConcurrentObj() {
+        if (construction_throw_countdown.fetch_sub(1) == 1) {
+            throw std::runtime_error("Oops");
+        }
+        ++num_alive;
+    }
+    ConcurrentObj(const ConcurrentObj& other)
+        : throw_on_copy(other.throw_on_copy) {
+        if (other.throw_on_copy) {
+            throw std::runtime_error("Oops");
+        }
+        ++num_alive;
+    }
+    ConcurrentObj& operator=(const ConcurrentObj&) = default;
+    ~ConcurrentObj() {
+        --num_alive;
+    }
+
+    bool throw_on_copy = false;
+
+    static inline std::atomic<int> num_alive = 0;
+    // Конструктор по умолчанию выбрасывает исключение, когда счётчик достигает нуля
+    static inline std::atomic<int> construction_throw_countdown = 0;
+};
+
+struct IntStatsTag {
+    static constexpr std::string_view NAME = "test_int";
+};
+
+struct FallbackStatsTag {
+    static constexpr std::string_view NAME = "test_fallback";
+};
+
 }  // namespace
 
+template <>
+struct IsTriviallyRelocatable<RelocObj> : std::true_type {};
+
 void Test1() {
     Obj::ResetCounters();
     const size_t SIZE = 100500;
@@ -433,7 +621,7 @@ void Test6() {
     {
         Obj::ResetCounters();
         Vector<Obj> v;
-        auto* pos = v.Emplace(v.end(), Obj{1});
+        auto pos = v.Emplace(v.end(), Obj{1});
         assert(v.Size() == 1);
         assert(v.Capacity() >= v.Size());
         assert(&*pos == &v[0]);
@@ -448,7 +636,7 @@ void Test6() {
         Obj::ResetCounters();
         Vector<Obj> v;
         v.Reserve(SIZE);
-        auto* pos = v.Emplace(v.end(), Obj{1});
+        auto pos = v.Emplace(v.end(), Obj{1});
         assert(v.Size() == 1);
         assert(v.Capacity() >= v.Size());
         assert(&*pos == &v[0]);
@@ -495,7 +683,7 @@ void Test6() {
     {
         Obj::ResetCounters();
         Vector<Obj> v{SIZE};
-        auto* pos = v.Emplace(v.cbegin() + 1, ID, "Ivan"s);
+        auto pos = v.Emplace(v.cbegin() + 1, ID, "Ivan"s);
         assert(v.Size() == SIZE + 1);
         assert(v.Capacity() == SIZE * 2);
         assert(&*pos == &v[1]);
@@ -511,7 +699,7 @@ void Test6() {
     {
         Obj::ResetCounters();
         Vector<Obj> v{SIZE};
-        auto* pos = v.Emplace(v.cbegin() + v.Size(), ID, "Ivan"s);
+        auto pos = v.Emplace(v.cbegin() + v.Size(), ID, "Ivan"s);
         assert(v.Size() == SIZE + 1);
         assert(v.Capacity() == SIZE * 2);
         assert(&*pos == &v[SIZE]);
@@ -530,7 +718,7 @@ void Test6() {
         v.Reserve(SIZE * 2);
         const int old_num_moved = Obj::num_moved;
         assert(v.Capacity() == SIZE * 2);
-        auto* pos = v.Emplace(v.cbegin() + 3, ID, "Ivan"s);
+        auto pos = v.Emplace(v.cbegin() + 3, ID, "Ivan"s);
         assert(v.Size() == SIZE + 1);
         assert(&*pos == &v[3]);
         assert(v[3].id == ID);
@@ -546,7 +734,7 @@ void Test6() {
         Obj::ResetCounters();
         Vector<Obj> v{SIZE};
         v[2].id = ID;
-        auto* pos = v.Erase(v.cbegin() + 1);
+        auto pos = v.Erase(v.cbegin() + 1);
         assert((pos - v.begin()) == 1);
         assert(v.Size() == SIZE - 1);
         assert(v.Capacity() == SIZE);
@@ -559,85 +747,2111 @@ void Test6() {
     }
 }
 
-struct C {
-    C() noexcept {
-        ++def_ctor;
+void Test7() {
+    const size_t SIZE = 100;
+    {
+        RelocObj::ResetCounters();
+        {
+            Vector<RelocObj> v;
+            v.Reserve(SIZE / 4);
+            for (size_t i = 0; i != SIZE; ++i) {
+                v.EmplaceBack(static_cast<int>(i));
+            }
+            v.Reserve(SIZE);
+            v.Emplace(v.cbegin() + SIZE / 2, -1);
+            assert(v.Capacity() == SIZE * 2);
+            assert(v.Size() == SIZE + 1);
+            assert(v[SIZE / 2].id == -1);
+            assert(v[SIZE / 2 - 1].id == SIZE / 2 - 1);
+            assert(v[SIZE / 2 + 1].id == SIZE / 2);
+            assert(v[SIZE].id == SIZE - 1);
+            // Реаллокации переносят элементы побайтово
+            assert(RelocObj::num_copied == 0);
+            assert(RelocObj::num_destroyed == 0);
+        }
+        assert(RelocObj::num_destroyed == SIZE + 1);
     }
-    C(const C& /*other*/) noexcept {
-        ++copy_ctor;
+    {
+        Vector<int> v;
+        for (int i = 0; i != static_cast<int>(SIZE); ++i) {
+            v.Insert(v.cbegin(), i);
+        }
+        for (size_t i = 0; i != SIZE; ++i) {
+            assert(v[i] == static_cast<int>(SIZE - 1 - i));
+        }
     }
-    C(C&& /*other*/) noexcept {
-        ++move_ctor;
+    {
+        Vector<std::unique_ptr<int>> v;
+        for (int i = 0; i != static_cast<int>(SIZE); ++i) {
+            v.PushBack(std::make_unique<int>(i));
+        }
+        for (size_t i = 0; i != SIZE; ++i) {
+            assert(*v[i] == static_cast<int>(i));
+        }
     }
-    C& operator=(const C& other) noexcept {
-        if (this != &other) {
-            ++copy_assign;
+}
+
+void Test8() {
+    const size_t SIZE = 100;
+    {
+        CountingResource resource;
+        {
+            pmr::Vector<int> v(&resource);
+            for (int i = 0; i != static_cast<int>(SIZE); ++i) {
+                v.PushBack(i);
+            }
+            assert(v.GetAllocator().resource() == &resource);
+            assert(resource.num_allocated > 0);
+
+            // Копия не наследует ресурс памяти оригинала
+            pmr::Vector<int> v_copy(v);
+            assert(v_copy.GetAllocator().resource() == std::pmr::get_default_resource());
+            assert(v_copy.Size() == SIZE);
+            assert(v_copy[SIZE - 1] == static_cast<int>(SIZE - 1));
+
+            pmr::Vector<int> v_arena_copy(v, &resource);
+            assert(v_arena_copy.GetAllocator().resource() == &resource);
         }
-        return *this;
+        assert(resource.num_allocated == resource.num_deallocated);
     }
-    C& operator=(C&& /*other*/) noexcept {
-        ++move_assign;
-        return *this;
+    {
+        CountingResource resource;
+        CountingResource other_resource;
+        {
+            Obj::ResetCounters();
+            pmr::Vector<Obj> v(SIZE, &resource);
+            pmr::Vector<Obj> other(&other_resource);
+            other = std::move(v);
+            // Ресурсы различны, поэтому элементы перемещаются поштучно
+            assert(other.GetAllocator().resource() == &other_resource);
+            assert(other.Size() == SIZE);
+            assert(Obj::num_moved == SIZE);
+
+            const int other_allocations = other_resource.num_allocated;
+            pmr::Vector<Obj> same(&other_resource);
+            same = std::move(other);
+            // Ресурсы равны, поэтому буфер забирается целиком
+            assert(same.Size() == SIZE);
+            assert(other_resource.num_allocated == other_allocations);
+            assert(Obj::num_moved == SIZE);
+        }
+        assert(resource.num_allocated == resource.num_deallocated);
+        assert(other_resource.num_allocated == other_resource.num_deallocated);
     }
-    ~C() {
-        ++dtor;
+    {
+        std::byte buffer[1024];
+        std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+        pmr::Vector<int> v(&arena);
+        v.Reserve(SIZE);
+        v.Resize(SIZE);
+        assert(reinterpret_cast<std::byte*>(&v[0]) >= buffer);
+        assert(reinterpret_cast<std::byte*>(&v[0]) < buffer + sizeof(buffer));
     }
+}
 
-    static void Reset() {
-        def_ctor = 0;
-        copy_ctor = 0;
-        move_ctor = 0;
-        copy_assign = 0;
-        move_assign = 0;
-        dtor = 0;
+void Test9() {
+    {
+        Vector<int, std::allocator<int>, GoldenGrowth> v;
+        std::vector<size_t> capacities;
+        for (int i = 0; i != 20; ++i) {
+            if (v.Size() == v.Capacity()) {
+                v.PushBack(i);
+                capacities.push_back(v.Capacity());
+            } else {
+                v.PushBack(i);
+            }
+        }
+        assert((capacities == std::vector<size_t>{1, 2, 3, 5, 8, 12, 18, 27}));
+        assert(v[19] == 19);
     }
+    {
+        Vector<int, std::allocator<int>, CacheLineGrowth<>> v;
+        v.PushBack(1);
+        assert(v.Capacity() == 64 / sizeof(int));
+        for (int i = 0; i != 16; ++i) {
+            v.PushBack(i);
+        }
+        assert(v.Capacity() == 2 * 64 / sizeof(int));
+    }
+    {
+        struct Big {
+            char data[100];
+        };
+        Vector<Big, std::allocator<Big>, CacheLineGrowth<>> v;
+        v.EmplaceBack();
+        assert(v.Capacity() == 1);
+    }
+    {
+        struct Triple {
+            char data[3];
+        };
+        using Growth = PageGrowth<DoublingGrowth, 4096, 4096>;
+        assert(Growth::NextCapacity<int>(0, 1) == 1);
+        assert(Growth::NextCapacity<int>(1024, 1025) == 2048);
+        // 4000 элементов по 3 байта округляются до трёх страниц
+        assert(Growth::NextCapacity<Triple>(2000, 2001) == 3 * 4096 / 3);
 
-    inline static size_t def_ctor = 0;
-    inline static size_t copy_ctor = 0;
-    inline static size_t move_ctor = 0;
-    inline static size_t copy_assign = 0;
-    inline static size_t move_assign = 0;
-    inline static size_t dtor = 0;
-};
-
-void Dump() {
-    using namespace std;
-    cerr << "Def ctors: "sv << C::def_ctor              //
-         << ", Copy ctors: "sv << C::copy_ctor          //
-         << ", Move ctors: "sv << C::move_ctor          //
-         << ", Copy assignments: "sv << C::copy_assign  //
-         << ", Move assignments: "sv << C::move_assign  //
-         << ", Dtors: "sv << C::dtor << endl;
+        Vector<Triple, std::allocator<Triple>, Growth> v;
+        v.Resize(2000);
+        v.EmplaceBack();
+        assert(v.Capacity() == 3 * 4096 / 3);
+    }
 }
 
-void Benchmark() {
-    using namespace std;
-    try {
-        const size_t NUM = 10;
-        C c;
+void Test10() {
+    const size_t N = 8;
+    const int ID = 42;
+    using namespace std::literals;
+    {
+        Obj::ResetCounters();
+        CountingResource resource;
         {
-            cerr << "std::vector:"sv << endl;
-            C::Reset();
-            vector<C> v(NUM);
-            Dump();
-            v.push_back(c);
+            SmallVector<Obj, N, std::pmr::polymorphic_allocator<Obj>> v(&resource);
+            assert(v.Capacity() == N);
+            assert(v.Size() == 0);
+            for (size_t i = 0; i != N; ++i) {
+                v.EmplaceBack(static_cast<int>(i));
+            }
+            // Встроенного буфера хватает, память не выделяется
+            assert(resource.num_allocated == 0);
+            assert(reinterpret_cast<const char*>(&v[0]) >= reinterpret_cast<const char*>(&v));
+            assert(reinterpret_cast<const char*>(&v[N - 1]) < reinterpret_cast<const char*>(&v + 1));
+
+            v.EmplaceBack(ID, "Ivan"s);
+            assert(resource.num_allocated == 1);
+            assert(v.Capacity() == N * 2);
+            assert(v.Size() == N + 1);
+            assert(v[N].id == ID && v[N].name == "Ivan"s);
+            assert(v[N - 1].id == static_cast<int>(N - 1));
+            assert(Obj::num_moved == N);
+            assert(Obj::GetAliveObjectCount() == N + 1);
         }
-        Dump();
-    } catch (...) {
+        assert(resource.num_allocated == resource.num_deallocated);
+        assert(Obj::GetAliveObjectCount() == 0);
     }
-    try {
-        const size_t NUM = 10;
-        C c;
-        {
-            cerr << "Vector:"sv << endl;
-            C::Reset();
-            Vector<C> v(NUM);
-            Dump();
-            v.PushBack(c);
+    {
+        Obj::ResetCounters();
+        SmallVector<Obj, N> v(N / 2);
+        v.Insert(v.cbegin() + 1, Obj{ID});
+        v.Emplace(v.cbegin(), ID + 1);
+        assert(v.Size() == N / 2 + 2);
+        assert(v.Capacity() == N);
+        assert(v[0].id == ID + 1);
+        assert(v[2].id == ID);
+        v.Erase(v.cbegin());
+        assert(v[1].id == ID);
+        v.Resize(N * 2);
+        assert(v.Capacity() == N * 2);
+        assert(v[1].id == ID);
+        v.Resize(1);
+        v.PopBack();
+        assert(v.Size() == 0);
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        Obj::ResetCounters();
+        SmallVector<Obj, N> v(N);
+        v[N - 1].throw_on_copy = true;
+        // Перемещение Obj не бросает исключений, поэтому элементы переносятся без копирования
+        v.Reserve(N * 2);
+        assert(v.Capacity() == N * 2);
+        assert(Obj::num_copied == 0);
+        assert(Obj::GetAliveObjectCount() == N);
+
+        v[N / 2].throw_on_copy = true;
+        try {
+            SmallVector<Obj, N> v_copy(v);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(Obj::GetAliveObjectCount() == N);
+    }
+    {
+        Obj::ResetCounters();
+        Obj::default_construction_throw_countdown = N / 2;
+        try {
+            SmallVector<Obj, N> v(N);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        Obj::ResetCounters();
+        SmallVector<Obj, N> small(N / 2);
+        small[0].id = ID;
+        SmallVector<Obj, N> large(N * 2);
+        large[0].id = ID + 1;
+        const Obj* large_data = &large[0];
+
+        SmallVector<Obj, N> moved_small(std::move(small));
+        assert(moved_small.Size() == N / 2);
+        assert(moved_small[0].id == ID);
+        assert(small.Size() == 0);
+
+        SmallVector<Obj, N> moved_large(std::move(large));
+        // Буфер в куче забирается без перемещения элементов
+        assert(&moved_large[0] == large_data);
+        assert(large.Size() == 0);
+        assert(large.Capacity() == N);
+
+        moved_small.Swap(moved_large);
+        assert(moved_small.Size() == N * 2);
+        assert(&moved_small[0] == large_data);
+        assert(moved_large.Size() == N / 2);
+        assert(moved_large[0].id == ID);
+
+        moved_small = moved_large;
+        assert(moved_small.Size() == N / 2);
+        assert(moved_small.Capacity() == N * 2);
+        assert(moved_small[0].id == ID);
+        assert(Obj::GetAliveObjectCount() == N);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        SmallVector<TestObj, N> v(N);
+        v.PushBack(v[0]);
+        v.Insert(v.cbegin() + 2, v[0]);
+        v.Emplace(v.cbegin() + 2, std::move(v[1]));
+        assert(std::all_of(v.begin(), v.end(), [](const TestObj& obj) {
+            return obj.IsAlive();
+        }));
+    }
+}
+
+void Test11() {
+    const size_t SIZE = 10;
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        std::vector<Obj> source;
+        for (int i = 1; i <= 3; ++i) {
+            source.emplace_back(i);
+        }
+        const int old_num_copied = Obj::num_copied;
+        const int old_num_moved = Obj::num_moved;
+        auto pos = v.Insert(v.cbegin() + 2, source.begin(), source.end());
+        // Одна реаллокация, хвост переносится один раз
+        assert(v.Capacity() == SIZE * 2);
+        assert(pos == v.begin() + 2);
+        assert(v.Size() == SIZE + 3);
+        assert(v[2].id == 1 && v[3].id == 2 && v[4].id == 3);
+        assert(Obj::num_copied - old_num_copied == 3);
+        assert(Obj::num_moved - old_num_moved == SIZE);
+
+        // Вставка в пределах вместимости, хвост длиннее вставляемого диапазона
+        Obj::ResetCounters();
+        v.Insert(v.cbegin() + 1, source.begin(), source.begin() + 2);
+        assert(v.Size() == SIZE + 5);
+        assert(v[1].id == 1 && v[2].id == 2 && v[3].id == 0 && v[4].id == 1);
+        assert(Obj::num_copied == 0);
+        assert(Obj::num_assigned == 2);
+        assert(Obj::num_moved == 2);
+        assert(Obj::num_move_assigned == SIZE + 3 - 1 - 2);
+
+        // Вставка в пределах вместимости, хвост короче вставляемого диапазона
+        Obj::ResetCounters();
+        v.Insert(v.cbegin() + v.Size() - 1, source.begin(), source.end());
+        assert(v.Size() == SIZE + 8);
+        assert(v[SIZE + 4].id == 1 && v[SIZE + 5].id == 2 && v[SIZE + 6].id == 3);
+        assert(v[SIZE + 7].id == 0);
+        assert(Obj::num_copied == 2);
+        assert(Obj::num_assigned == 1);
+        assert(Obj::num_moved == 1);
+    }
+    {
+        Vector<int> v;
+        v.Append({1, 2, 3, 4});
+        v.Insert(v.cbegin() + 1, 3, v[3]);
+        assert((std::vector<int>(v.begin(), v.end()) == std::vector<int>{1, 4, 4, 4, 2, 3, 4}));
+        v.Insert(v.cbegin(), {7, 8});
+        assert((std::vector<int>(v.begin(), v.end()) == std::vector<int>{7, 8, 1, 4, 4, 4, 2, 3, 4}));
+        v.Append(std::vector<int>{5, 6});
+        v.Append({9});
+        assert((std::vector<int>(v.begin(), v.end()) == std::vector<int>{7, 8, 1, 4, 4, 4, 2, 3, 4, 5, 6, 9}));
+
+        std::istringstream input("10 11 12");
+        v.Insert(v.cbegin() + 1, std::istream_iterator<int>(input), std::istream_iterator<int>());
+        assert((std::vector<int>(v.begin(), v.begin() + 5) == std::vector<int>{7, 10, 11, 12, 8}));
+        assert(v.Size() == 15);
+
+        v.Append(v);
+        assert(v.Size() == 30);
+        assert(v[15] == 7 && v[29] == 9);
+    }
+    {
+        Vector<std::string> v;
+        v.Insert(v.cbegin(), 2, "a");
+        v.Insert(v.cbegin() + 1, {"b", "c"});
+        v.Reserve(10);
+        v.Insert(v.cbegin() + 1, 2, "d");
+        assert((std::vector<std::string>(v.begin(), v.end()) == std::vector<std::string>{"a", "d", "d", "b", "c", "a"}));
+    }
+    {
+        // При исключении во время вставки с реаллокацией вектор не изменяется
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        std::vector<Obj> source(3);
+        source[1].throw_on_copy = true;
+        try {
+            v.Insert(v.cbegin() + 1, source.begin(), source.end());
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == SIZE);
+        assert(v.Capacity() == SIZE);
+        assert(Obj::GetAliveObjectCount() == SIZE + 3);
+    }
+    {
+        // Для тривиально перемещаемых типов вставка в пределах вместимости строго безопасна
+        RelocObj::ResetCounters();
+        Vector<RelocObj> v;
+        v.Reserve(SIZE);
+        for (int i = 0; i != 4; ++i) {
+            v.EmplaceBack(i);
+        }
+        v.Insert(v.cbegin() + 1, 2, RelocObj{7});
+        assert(v.Size() == 6);
+        assert(v[0].id == 0 && v[1].id == 7 && v[2].id == 7 && v[3].id == 1 && v[5].id == 3);
+        assert(RelocObj::num_moved == 0);
+    }
+}
+
+void Test12() {
+    const size_t SIZE = 10;
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        for (size_t i = 0; i != SIZE; ++i) {
+            v[i].id = static_cast<int>(i);
+        }
+        auto pos = v.Erase(v.cbegin() + 2, v.cbegin() + 5);
+        assert(pos == v.begin() + 2);
+        assert(v.Size() == SIZE - 3);
+        assert(v.Capacity() == SIZE);
+        assert(v[1].id == 1 && v[2].id == 5 && v[SIZE - 4].id == SIZE - 1);
+        assert(Obj::num_move_assigned == SIZE - 5);
+        assert(Obj::num_destroyed == 3);
+        assert(Obj::GetAliveObjectCount() == SIZE - 3);
+
+        assert(v.Erase(v.cbegin() + 1, v.cbegin() + 1) == v.begin() + 1);
+        assert(v.Size() == SIZE - 3);
+
+        pos = v.Erase(v.cbegin() + 3, v.cend());
+        assert(pos == v.end());
+        assert(v.Size() == 3);
+        assert(Obj::GetAliveObjectCount() == 3);
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        for (size_t i = 0; i != SIZE; ++i) {
+            v[i].id = static_cast<int>(i);
+        }
+        const size_t removed = EraseIf(v, [](const Obj& obj) {
+            return obj.id % 3 == 0;
+        });
+        assert(removed == 4);
+        assert(v.Size() == SIZE - 4);
+        assert(v[0].id == 1 && v[1].id == 2 && v[2].id == 4 && v[5].id == 8);
+        assert(Obj::GetAliveObjectCount() == SIZE - 4);
+
+        Obj::ResetCounters();
+        auto pos = v.SwapErase(v.cbegin() + 1);
+        assert(pos == v.begin() + 1);
+        assert(v.Size() == SIZE - 5);
+        assert(v[1].id == 8);
+        assert(Obj::num_move_assigned == 1);
+        assert(Obj::num_destroyed == 1);
+
+        v.SwapErase(v.cend() - 1);
+        assert(v.Size() == SIZE - 6);
+        assert(v[v.Size() - 1].id == 5);
+    }
+    {
+        Vector<TestObj> v(SIZE);
+        v.Erase(v.cbegin() + 1);
+        v.Erase(v.cbegin(), v.cbegin() + 2);
+        v.SwapErase(v.cbegin());
+        assert(v.Size() == SIZE - 4);
+        assert(std::all_of(v.begin(), v.end(), [](const TestObj& obj) {
+            return obj.IsAlive();
+        }));
+    }
+    {
+        RelocObj::ResetCounters();
+        Vector<RelocObj> v;
+        for (int i = 0; i != static_cast<int>(SIZE); ++i) {
+            v.EmplaceBack(i);
+        }
+        RelocObj::ResetCounters();
+        v.Erase(v.cbegin() + 1, v.cbegin() + 3);
+        assert(v.Size() == SIZE - 2);
+        assert(v[1].id == 3 && v[SIZE - 3].id == SIZE - 1);
+        v.SwapErase(v.cbegin());
+        assert(v[0].id == SIZE - 1);
+        assert(RelocObj::num_destroyed == 3);
+        assert(RelocObj::num_moved == 0);
+        EraseIf(v, [](const RelocObj& obj) {
+            return obj.id > 5;
+        });
+        assert(v.Size() == 3);
+        assert(v[0].id == 3 && v[1].id == 4 && v[2].id == 5);
+    }
+}
+
+void Test13() {
+    const size_t SIZE = 100;
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE, DEFAULT_INIT);
+        assert(v.Size() == SIZE);
+        assert(Obj::num_default_constructed == SIZE);
+        v.ResizeDefaultInit(SIZE * 2);
+        assert(v.Size() == SIZE * 2);
+        assert(Obj::num_default_constructed == SIZE * 2);
+        v.ResizeDefaultInit(SIZE / 2);
+        assert(v.Size() == SIZE / 2);
+        assert(Obj::GetAliveObjectCount() == SIZE / 2);
+    }
+    {
+        Vector<int> v(SIZE, DEFAULT_INIT);
+        v.ResizeDefaultInit(SIZE * 2);
+        v[SIZE * 2 - 1] = 1;
+        assert(v.Capacity() == SIZE * 2);
+    }
+    {
+        Vector<char> v;
+        v.Append({'a', 'b'});
+        const std::string input = "cdefgh";
+        v.ResizeAndOverwrite(SIZE, [&input](char* data, size_t size) {
+            assert(size == SIZE);
+            assert(data[0] == 'a' && data[1] == 'b');
+            std::copy(input.begin(), input.end(), data + 2);
+            return input.size() + 2;
+        });
+        assert(v.Size() == 8);
+        assert(v.Capacity() == SIZE);
+        assert(std::string(v.begin(), v.end()) == "abcdefgh");
+
+        try {
+            v.ResizeAndOverwrite(SIZE * 2, [](char*, size_t) -> size_t {
+                throw std::runtime_error("Oops");
+            });
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
         }
-        Dump();
-    } catch (...) {
+        assert(v.Size() == 8);
+        assert(std::string(v.begin(), v.end()) == "abcdefgh");
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(2);
+        v.ResizeAndOverwrite(SIZE, [](Obj* data, size_t size) {
+            for (size_t i = 0; i != size; ++i) {
+                data[i].id = static_cast<int>(i);
+            }
+            return size_t{3};
+        });
+        assert(v.Size() == 3);
+        assert(v[2].id == 2);
+        assert(Obj::GetAliveObjectCount() == 3);
+    }
+}
+
+void Test14() {
+    const size_t SIZE = 100;
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        v[SIZE / 2 - 1].id = SIZE;
+        v.Resize(SIZE / 2);
+        v.ShrinkTo(SIZE * 2);
+        assert(v.Capacity() == SIZE);
+        v.ShrinkTo(SIZE * 3 / 4);
+        assert(v.Capacity() == SIZE * 3 / 4);
+        assert(Obj::num_copied == 0);
+        assert(Obj::num_moved == SIZE / 2);
+        v.ShrinkTo(0);
+        assert(v.Capacity() == SIZE / 2);
+        assert(v[SIZE / 2 - 1].id == SIZE);
+        assert(Obj::GetAliveObjectCount() == SIZE / 2);
+
+        v.Resize(0);
+        v.ShrinkToFit();
+        assert(v.Capacity() == 0);
+        assert(v.begin() == nullptr);
+        v.PushBack(Obj{1});
+        assert(v.Capacity() == 1);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        Vector<int> v;
+        v.ShrinkToFit();
+        assert(v.Capacity() == 0);
+        v.Resize(SIZE);
+        v.PopBack();
+        v.ShrinkToFit();
+        assert(v.Capacity() == SIZE - 1);
+        assert(v.Size() == SIZE - 1);
+    }
+    {
+        const size_t N = 8;
+        Obj::ResetCounters();
+        SmallVector<Obj, N> v(SIZE);
+        v[1].id = 1;
+        v.Resize(N / 2);
+        v.ShrinkToFit();
+        assert(v.Capacity() == N);
+        assert(reinterpret_cast<const char*>(&v[0]) >= reinterpret_cast<const char*>(&v));
+        assert(reinterpret_cast<const char*>(&v[0]) < reinterpret_cast<const char*>(&v + 1));
+        assert(v[1].id == 1);
+        assert(Obj::GetAliveObjectCount() == N / 2);
+        v.ShrinkToFit();
+        assert(v.Capacity() == N);
+        assert(v[1].id == 1);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+void Test15() {
+    const size_t SIZE = 100'000;
+    {
+        Vector<int, MallocAllocator<int>> v;
+        for (int i = 0; i != static_cast<int>(SIZE); ++i) {
+            v.PushBack(i);
+        }
+        assert(v.Capacity() >= SIZE);
+        v.Reserve(SIZE * 4);
+        assert(v.Capacity() >= SIZE * 4);
+        v.Insert(v.cbegin() + 1, 3, 7);
+        v.Erase(v.cbegin() + 1, v.cbegin() + 4);
+        for (size_t i = 0; i != SIZE; ++i) {
+            assert(v[i] == static_cast<int>(i));
+        }
+        v.ShrinkToFit();
+        assert(v.Capacity() >= SIZE);
+    }
+    {
+        // Аргумент ссылается на элемент, который realloc может перенести
+        Vector<TestObj, MallocAllocator<TestObj>> v(1);
+        for (int i = 0; i != 100; ++i) {
+            v.PushBack(v[0]);
+            v.Insert(v.cbegin(), v[v.Size() - 1]);
+        }
+        assert(std::all_of(v.begin(), v.end(), [](const TestObj& obj) {
+            return obj.IsAlive();
+        }));
+    }
+    {
+        RelocObj::ResetCounters();
+        {
+            Vector<RelocObj, MallocAllocator<RelocObj>> v;
+            for (int i = 0; i != 1000; ++i) {
+                v.EmplaceBack(i);
+                v.PushBack(v[v.Size() - 1]);
+            }
+            v.Reserve(SIZE);
+            assert(v[1999].id == 999);
+            assert(RelocObj::num_copied == 1000);
+        }
+        assert(RelocObj::num_copied + RelocObj::num_moved + 1000 == RelocObj::num_destroyed);
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj, MallocAllocator<Obj>> v(10);
+        v.PushBack(Obj{1});
+        assert(v[10].id == 1);
+        SmallVector<Obj, 4, MallocAllocator<Obj>> sv(3);
+        sv.Resize(10);
+        sv.EmplaceBack(2);
+        assert(sv[10].id == 2);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        std::byte buffer[4096];
+        BumpAllocator<Obj> alloc(buffer, sizeof(buffer));
+        Obj::ResetCounters();
+        {
+            Vector<Obj, BumpAllocator<Obj>> v(4, alloc);
+            const Obj* data = &v[0];
+            v.Reserve(8);
+            v.PushBack(Obj{1});
+            v.Resize(20);
+            v.EmplaceBack(v[0]);
+            // Блок расширялся на месте, элементы не перемещались
+            assert(&v[0] == data);
+            assert(Obj::num_moved == 1);
+            assert(v.Capacity() >= 21);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+}
+
+void Test16() {
+    static_assert(sizeof(Vector<int>) == sizeof(Vector<int, std::allocator<int>, DoublingGrowth, CountingStats<IntStatsTag>>));
+    using IntVector = Vector<int, std::allocator<int>, DoublingGrowth, CountingStats<IntStatsTag>>;
+    // Первое обращение к счётчикам происходит из noexcept-обработчиков и не должно выделять память
+    static_assert(noexcept(CountingStats<IntStatsTag>::Get()));
+    VectorStats& stats = CountingStats<IntStatsTag>::Get();
+    stats.Reset();
+    {
+        IntVector v;
+        for (int i = 0; i != 100; ++i) {
+            v.PushBack(i);
+        }
+        // Вместимость росла 1, 2, 4, ..., 128
+        VectorStatsSnapshot snapshot = stats.GetSnapshot();
+        assert(snapshot.name == "test_int");
+        assert(snapshot.reallocations == 8);
+        assert(snapshot.peak_capacity == 128);
+        assert(snapshot.bytes_relocated == (1 + 2 + 4 + 8 + 16 + 32 + 64) * sizeof(int));
+        assert(snapshot.copy_fallbacks == 0);
+
+        IntVector copy(v);
+        assert(stats.GetSnapshot().bytes_copied == 100 * sizeof(int));
+        copy = v;
+        assert(stats.GetSnapshot().bytes_copied == 200 * sizeof(int));
+    }
+    {
+        VectorStatsSnapshot snapshot = stats.GetSnapshot();
+        assert(snapshot.destroyed == 2);
+        assert(snapshot.wasted_elements == 128 - 100);
+
+        IntVector v;
+        v.Reserve(100);
+        for (int i = 0; i != 100; ++i) {
+            v.PushBack(i);
+        }
+        assert(stats.GetSnapshot().reallocations == snapshot.reallocations + 1);
+    }
+    {
+        using FallbackVector = Vector<ThrowingMoveObj, std::allocator<ThrowingMoveObj>, DoublingGrowth,
+                                      CountingStats<FallbackStatsTag>>;
+        FallbackVector v(4);
+        v.Reserve(8);
+        VectorStatsSnapshot snapshot = CountingStats<FallbackStatsTag>::Get().GetSnapshot();
+        assert(snapshot.copy_fallbacks == 1);
+        assert(snapshot.bytes_copied == 4 * sizeof(ThrowingMoveObj));
+        assert(snapshot.bytes_relocated == 0);
+    }
+    {
+        const std::vector<VectorStatsSnapshot> snapshots = VectorStatsRegistry::Instance().GetSnapshots();
+        assert(std::count_if(snapshots.begin(), snapshots.end(), [](const VectorStatsSnapshot& snapshot) {
+            return snapshot.name == "test_int" || snapshot.name == "test_fallback";
+        }) == 2);
+        VectorStatsRegistry::Instance().ResetAll();
+        assert(stats.GetSnapshot().reallocations == 0);
+    }
+}
+
+void Test17() {
+    using namespace std::literals;
+    {
+        Vector<int> v;
+        v.Assign(5, 7);
+        assert(v.Size() == 5 && v[4] == 7);
+        const size_t capacity = v.Capacity();
+        v.Assign(3, v[0]);
+        assert(v.Size() == 3 && v[2] == 7);
+        v.Assign({1, 2, 3, 4});
+        assert(v.Size() == 4 && v[3] == 4);
+        assert(v.Capacity() == capacity);
+        const int values[] = {5, 6, 7, 8, 9, 10};
+        v.Assign(std::begin(values), std::end(values));
+        assert(v.Size() == 6 && v[0] == 5 && v[5] == 10);
+        std::istringstream input("1 2 3");
+        v.Assign(std::istream_iterator<int>(input), std::istream_iterator<int>());
+        assert(v.Size() == 3 && v[0] == 1 && v[2] == 3);
+    }
+    {
+        // Присваивание из итераторов ввода не требует конструктора по умолчанию
+        struct NoDefault {
+            explicit NoDefault(int value)
+                : value(value) {
+            }
+            int value;
+        };
+        Vector<NoDefault> v;
+        v.EmplaceBack(0);
+        std::istringstream input("4 5");
+        v.Assign(std::istream_iterator<int>(input), std::istream_iterator<int>());
+        assert(v.Size() == 2 && v[0].value == 4 && v[1].value == 5);
+    }
+    {
+        Vector<std::string> v;
+        v.Assign(2, "abc"s);
+        const std::vector<std::string> source{"x"s, "y"s, "z"s};
+        v.Assign(source.begin(), source.end());
+        assert(v.Size() == 3 && v[0] == "x"s && v[2] == "z"s);
+        v.Assign(source.begin(), source.begin() + 1);
+        assert(v.Size() == 1 && v[0] == "x"s);
+        v.Assign(10, v[0]);
+        assert(v.Size() == 10 && v[9] == "x"s);
+    }
+    {
+        // Копирующее присваивание переиспользует память, если её достаточно
+        Vector<int> small;
+        small.Assign(3, 1);
+        Vector<int> large;
+        large.Assign(10, 2);
+        const int* data = &large[0];
+        large = small;
+        assert(large.Size() == 3 && large[2] == 1 && &large[0] == data);
+        small = large;
+        assert(small.Size() == 3);
+        Vector<int> larger;
+        larger.Assign(20, 3);
+        large = larger;
+        assert(large.Size() == 20 && large[19] == 3);
+    }
+    {
+        SmallVector<std::string, 2> sv;
+        sv.Assign({"a"s, "b"s});
+        SmallVector<std::string, 2> other;
+        other.Assign(5, "c"s);
+        sv = other;
+        assert(sv.Size() == 5 && sv[4] == "c"s);
+        other.Assign(1, "d"s);
+        sv = other;
+        assert(sv.Size() == 1 && sv[0] == "d"s);
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(2);
+        Vector<Obj> source(3);
+        source[1].throw_on_copy = true;
+        try {
+            v = source;
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == 2);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+void Test18() {
+    const auto is_aligned = [](const void* ptr, size_t alignment) {
+        return reinterpret_cast<std::uintptr_t>(ptr) % alignment == 0;
+    };
+    {
+        AlignedVector<float, 64> v;
+        assert(v.Data() == nullptr);
+        for (int i = 0; i != 1000; ++i) {
+            v.PushBack(static_cast<float>(i));
+            assert(is_aligned(v.Data(), 64));
+            // Вместимость кратна числу float в 64 байтах
+            assert(v.Capacity() % 16 == 0);
+        }
+        v.Insert(v.cbegin(), 3, 1.0f);
+        v.ShrinkToFit();
+        assert(is_aligned(v.Data(), 64));
+        assert(v.Capacity() == 1008);
+        AlignedVector<float, 64> copy(v);
+        assert(is_aligned(copy.Data(), 64));
+        assert(copy[3] == 0.0f && copy[1002] == 999.0f);
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj, AlignedAllocator<Obj, 128>> v(3);
+        assert(is_aligned(v.Data(), 128));
+        assert(v.Capacity() == 3);
+        v.Reserve(10);
+        assert(is_aligned(v.Data(), 128));
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+void Test19() {
+    // Порог снижен, чтобы тест затрагивал переход между malloc и mmap
+    constexpr size_t THRESHOLD = 64 * 1024;
+    const auto is_page_aligned = [](const void* ptr) {
+        return reinterpret_cast<std::uintptr_t>(ptr) % 4096 == 0;
+    };
+    {
+        Vector<int, MmapAllocator<int, THRESHOLD>> v;
+        const int count = 1'000'000;
+        for (int i = 0; i != count; ++i) {
+            v.PushBack(i);
+        }
+        assert(is_page_aligned(v.Data()));
+        assert(v.Capacity() * sizeof(int) % 4096 == 0);
+        v.Reserve(v.Capacity() * 4);
+        v.Insert(v.cbegin(), 5, -1);
+        v.Erase(v.cbegin(), v.cbegin() + 5);
+        for (int i = 0; i != count; ++i) {
+            assert(v[i] == i);
+        }
+        v.Resize(10);
+        v.ShrinkToFit();
+        assert(v.Capacity() == 10);
+        assert(v[9] == 9);
+        v.Resize(count);
+        assert(v[9] == 9 && v[count - 1] == 0);
+        Vector<int, MmapAllocator<int, THRESHOLD>> copy(v);
+        assert(is_page_aligned(copy.Data()));
+        assert(copy[9] == 9);
+    }
+    {
+        Obj::ResetCounters();
+        {
+            Vector<Obj, MmapAllocator<Obj, THRESHOLD>> v;
+            for (int i = 0; i != 10'000; ++i) {
+                v.EmplaceBack(i);
+            }
+            assert(v[9'999].id == 9'999);
+            v.Resize(100);
+            v.ShrinkToFit();
+            assert(v[99].id == 99);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+}
+
+void Test20() {
+    struct Record {
+        int id;
+        double value;
+    };
+    const std::string path = "/tmp/advanced_vector_test20_" + std::to_string(getpid()) + ".bin";
+    {
+        MappedVector<Record> v = MappedVector<Record>::Create(path);
+        assert(v.Size() == 0 && v.Capacity() == 0);
+        for (int i = 0; i != 1000; ++i) {
+            v.PushBack({i, i * 0.5});
+        }
+        v.PushBack(v[0]);
+        v.EmplaceBack(Record{-1, -1.0});
+        assert(v.Size() == 1002);
+        v.Sync();
+    }
+    {
+        const MappedVector<Record> v = MappedVector<Record>::Open(path);
+        assert(v.Size() == 1002);
+        assert(v[999].id == 999 && v[999].value == 499.5);
+        assert(v[1000].id == 0 && v[1001].id == -1);
+    }
+    {
+        MappedVector<Record> v = MappedVector<Record>::Open(path, MapMode::COPY_ON_WRITE);
+        v[0].id = 42;
+        v.PopBack();
+        try {
+            v.Reserve(v.Capacity() + 1);
+            assert(false);
+        } catch (const std::logic_error&) {
+        }
+    }
+    {
+        MappedVector<Record> v = MappedVector<Record>::Open(path, MapMode::READ_WRITE);
+        // Изменения копии при записи не попали в файл
+        assert(v.Size() == 1002 && v[0].id == 0);
+        v.Resize(10);
+        v.Resize(20);
+        assert(v[19].id == 0 && v[9].id == 9);
+        MappedVector<Record> moved(std::move(v));
+        assert(moved.Size() == 20 && v.Size() == 0);
+    }
+    {
+        MappedVector<Record> v = MappedVector<Record>::Open(path);
+        assert(v.Size() == 20);
+        try {
+            v.PushBack({1, 1.0});
+            assert(false);
+        } catch (const std::logic_error&) {
+        }
+        // Заголовок отображён только для чтения, поэтому изменение размера должно выбрасывать исключение
+        try {
+            v.PopBack();
+            assert(false);
+        } catch (const std::logic_error&) {
+        }
+        try {
+            v.Clear();
+            assert(false);
+        } catch (const std::logic_error&) {
+        }
+        assert(v.Size() == 20);
+    }
+    try {
+        MappedVector<int> v = MappedVector<int>::Open(path);
+        assert(false);
+    } catch (const std::runtime_error&) {
+    }
+    unlink(path.c_str());
+}
+
+void Test21() {
+    const ParallelPolicy policy{4, 1000};
+    {
+        Vector<std::string> v(100'000, policy);
+        assert(v.Size() == 100'000 && v[99'999].empty());
+        v[50'000] = "x";
+        Vector<std::string> copy(v, policy);
+        assert(copy.Size() == 100'000 && copy[50'000] == "x");
+        copy.Resize(250'000, policy);
+        assert(copy.Size() == 250'000 && copy[50'000] == "x" && copy[249'999].empty());
+        copy.Resize(10, policy);
+        assert(copy.Size() == 10);
+        v.Clear(policy);
+        assert(v.Size() == 0);
+        copy.Clear();
+        assert(copy.Size() == 0);
+    }
+    {
+        // Маленький диапазон обрабатывается в текущем потоке
+        Vector<int> v(10, PARALLEL);
+        assert(v.Size() == 10 && v[9] == 0);
+    }
+    {
+        Vector<ConcurrentObj> source(10'000, policy);
+        assert(ConcurrentObj::num_alive == 10'000);
+        source[7'777].throw_on_copy = true;
+        try {
+            Vector<ConcurrentObj> copy(source, policy);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        // Успешно скопированные части уничтожены
+        assert(ConcurrentObj::num_alive == 10'000);
+
+        ConcurrentObj::construction_throw_countdown = 5'000;
+        try {
+            source.Resize(20'000, policy);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(source.Size() == 10'000);
+        assert(ConcurrentObj::num_alive == 10'000);
+        source.Clear(policy);
+        assert(ConcurrentObj::num_alive == 0);
+    }
+}
+
+void Test22() {
+    {
+        ConcurrentVector<int, std::allocator<int>, 4> v;
+        assert(v.Size() == 0 && v.Capacity() == 0);
+        int& first = v.EmplaceBack(1);
+        for (int i = 2; i <= 100; ++i) {
+            v.PushBack(i);
+        }
+        // Сегменты не перемещаются
+        assert(&first == &v[0] && first == 1);
+        assert(v.Size() == 100 && v[99] == 100);
+        // Сегмент, следующий за последним занятым, выделен заранее
+        assert(v.Capacity() == 4 + 8 + 16 + 32 + 64 + 128);
+        assert(v.TryGet(100) == nullptr);
+        v.Reserve(1000);
+        assert(v.Capacity() >= 1000);
+        int sum = 0;
+        v.ForEach([&sum](int value) {
+            sum += value;
+        });
+        assert(sum == 5050);
+        v.Clear();
+        assert(v.Size() == 0 && v.Capacity() >= 1000);
+    }
+    {
+        const int num_threads = 8;
+        const int per_thread = 20'000;
+        ConcurrentVector<std::string> v;
+        std::atomic<bool> done = false;
+        std::thread reader([&] {
+            while (!done) {
+                const size_t size = v.Size();
+                for (size_t i = 0; i < size; i += 97) {
+                    if (const std::string* value = v.TryGet(i)) {
+                        assert(!value->empty());
+                    }
+                }
+            }
+        });
+        std::vector<std::thread> writers;
+        for (int t = 0; t != num_threads; ++t) {
+            writers.emplace_back([&v, t] {
+                for (int i = 0; i != per_thread; ++i) {
+                    std::string& value = v.EmplaceBack(std::to_string(t * per_thread + i));
+                    assert(value == std::to_string(t * per_thread + i));
+                }
+            });
+        }
+        for (std::thread& writer : writers) {
+            writer.join();
+        }
+        done = true;
+        reader.join();
+        assert(v.Size() == num_threads * per_thread);
+        std::vector<bool> seen(num_threads * per_thread);
+        v.ForEach([&seen](const std::string& value) {
+            seen[std::stoi(value)] = true;
+        });
+        assert(std::all_of(seen.begin(), seen.end(), [](bool value) {
+            return value;
+        }));
+    }
+    {
+        ConcurrentObj::num_alive = 0;
+        ConcurrentObj::construction_throw_countdown = 3;
+        {
+            ConcurrentVector<ConcurrentObj> v;
+            v.EmplaceBack();
+            v.EmplaceBack();
+            try {
+                v.EmplaceBack();
+                assert(false);
+            } catch (const std::runtime_error&) {
+            }
+            v.EmplaceBack();
+            // Индекс элемента, конструктор которого выбросил исключение, не публикуется
+            assert(v.Size() == 4 && !v.IsPublished(2) && v.IsPublished(3));
+        }
+        assert(ConcurrentObj::num_alive == 0);
+    }
+    {
+        // Сегменты, выделенные проигравшими потоками, сразу освобождаются,
+        // а сегмент, его флаги и элементы получают память от аллокатора вектора
+        CountingResource resource;
+        {
+            ConcurrentVector<int, std::pmr::polymorphic_allocator<int>, 4> v(&resource);
+            std::vector<std::thread> writers;
+            for (int t = 0; t != 8; ++t) {
+                writers.emplace_back([&v] {
+                    for (int i = 0; i != 10'000; ++i) {
+                        v.PushBack(i);
+                    }
+                });
+            }
+            for (std::thread& writer : writers) {
+                writer.join();
+            }
+            size_t num_segments = 0;
+            for (size_t capacity = 0; capacity < v.Capacity(); ++num_segments) {
+                capacity += size_t{4} << num_segments;
+            }
+            assert(v.Capacity() > v.Size());
+            assert(resource.num_allocated - resource.num_deallocated == static_cast<int>(num_segments) * 3);
+        }
+        assert(resource.num_deallocated == resource.num_allocated);
+    }
+}
+
+void Test23() {
+    {
+        SegmentedVector<int, 8> v;
+        v.PushBack(0);
+        const int* first = &v[0];
+        for (int i = 1; i != 100; ++i) {
+            v.PushBack(i);
+        }
+        // Элементы не перемещаются при росте
+        assert(first == &v[0]);
+        assert(v.Size() == 100 && v.Capacity() == 104);
+        for (int i = 0; i != 100; ++i) {
+            assert(v[i] == i);
+        }
+        assert(std::is_sorted(v.begin(), v.end()));
+        assert(v.end() - v.begin() == 100);
+        assert(*(v.begin() + 42) == 42 && v.begin()[43] == 43);
+        assert(std::lower_bound(v.cbegin(), v.cend(), 57) - v.cbegin() == 57);
+        SegmentedVector<int, 8>::const_iterator it = v.begin();
+        assert(*it == 0);
+        std::reverse(v.begin(), v.end());
+        assert(v[0] == 99 && v[99] == 0);
+
+        v.Resize(10);
+        assert(v.Size() == 10 && v.Capacity() == 104);
+        v.ShrinkToFit();
+        assert(v.Capacity() == 16);
+        v.Resize(20);
+        assert(v[19] == 0 && v[9] == 90);
+    }
+    {
+        Obj::ResetCounters();
+        {
+            SegmentedVector<Obj, 4> v;
+            for (int i = 0; i != 10; ++i) {
+                v.EmplaceBack(i);
+            }
+            // Аргумент ссылается на элемент вектора
+            v.PushBack(v[0]);
+            assert(Obj::num_moved == 0 && v[10].id == 0);
+            SegmentedVector<Obj, 4> copy(v);
+            assert(copy.Size() == 11 && copy[9].id == 9);
+            v[5].throw_on_copy = true;
+            try {
+                SegmentedVector<Obj, 4> failed(v);
+                assert(false);
+            } catch (const std::runtime_error&) {
+            }
+            try {
+                copy = v;
+                assert(false);
+            } catch (const std::runtime_error&) {
+            }
+            assert(copy.Size() == 11);
+            SegmentedVector<Obj, 4> moved(std::move(v));
+            assert(moved.Size() == 11 && v.Size() == 0);
+            copy = std::move(moved);
+            assert(copy.Size() == 11 && copy[5].throw_on_copy);
+            copy.PopBack();
+            assert(copy.Size() == 10);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        // polymorphic_allocator не распространяется при присваивании, поэтому каждый вектор
+        // сохраняет свой ресурс, а блоки с другим ресурсом не забираются
+        using namespace std::literals;
+        using PmrVector = SegmentedVector<std::string, 4, std::pmr::polymorphic_allocator<std::string>>;
+        CountingResource first_resource;
+        CountingResource second_resource;
+        {
+            PmrVector lhs(&first_resource);
+            PmrVector rhs(&second_resource);
+            lhs.PushBack("a"s);
+            for (int i = 0; i != 10; ++i) {
+                rhs.PushBack(std::string(20, static_cast<char>('a' + i)));
+            }
+            lhs = rhs;
+            assert(lhs.GetAllocator().resource() == &first_resource);
+            assert(lhs.Size() == 10 && lhs[9] == std::string(20, 'j'));
+            const int num_allocated = second_resource.num_allocated;
+            lhs = std::move(rhs);
+            assert(lhs.GetAllocator().resource() == &first_resource);
+            assert(lhs.Size() == 10 && lhs[0] == std::string(20, 'a'));
+            assert(second_resource.num_allocated == num_allocated);
+
+            PmrVector same(&first_resource);
+            same.PushBack("b"s);
+            const int first_allocated = first_resource.num_allocated;
+            // При равных аллокаторах блоки забираются без выделений
+            same = std::move(lhs);
+            assert(same.Size() == 10 && lhs.Size() == 0);
+            assert(first_resource.num_allocated == first_allocated);
+            same.Swap(lhs);
+            assert(lhs.Size() == 10 && same.Size() == 0);
+        }
+        assert(first_resource.num_allocated == first_resource.num_deallocated);
+        assert(second_resource.num_allocated == second_resource.num_deallocated);
+    }
+}
+
+void Test24() {
+    using namespace std::literals;
+    {
+        SoaVector<float, float, int> particles;
+        for (int i = 0; i != 100; ++i) {
+            particles.EmplaceBack(static_cast<float>(i), 0.5f, i);
+        }
+        particles.PushBack({1.0f, 2.0f, 3});
+        assert(particles.Size() == 101 && particles.Capacity() == 128);
+        auto [x, y, id] = particles[100];
+        assert(x == 1.0f && y == 2.0f && id == 3);
+        // Прокси-ссылка позволяет изменять строку
+        x = 10.0f;
+        particles[0] = std::make_tuple(-1.0f, -1.0f, -1);
+        assert(particles.Get<0>(100) == 10.0f && particles.Get<2>(0) == -1);
+
+        float sum = 0;
+        for (float value : particles.Column<1>()) {
+            sum += value;
+        }
+        assert(sum == 99 * 0.5f - 1.0f + 2.0f);
+        assert(particles.Column<2>().Size() == 101 && particles.Column<2>()[50] == 50);
+
+        particles.Resize(10);
+        assert(particles.Size() == 10);
+        particles.Resize(20);
+        assert(particles.Get<2>(19) == 0);
+        particles.PopBack();
+        assert(particles.Size() == 19);
+    }
+    {
+        SoaVector<std::string, int> v;
+        v.EmplaceBack("a"s, 1);
+        for (int i = 0; i != 10; ++i) {
+            // Аргумент ссылается на элемент, который переносится при реаллокации
+            v.EmplaceBack(std::get<0>(v[0]), i);
+        }
+        assert(v.Size() == 11 && std::get<0>(v[10]) == "a"s);
+        SoaVector<std::string, int> copy(v);
+        assert(copy.Size() == 11 && copy.Get<1>(10) == 9);
+        SoaVector<std::string, int> moved(std::move(copy));
+        assert(moved.Size() == 11 && copy.Size() == 0);
+        copy = moved;
+        moved = std::move(v);
+        assert(copy.Size() == 11 && moved.Size() == 11);
+    }
+    {
+        Obj::ResetCounters();
+        {
+            SoaVector<Obj, ThrowingMoveObj> v;
+            v.EmplaceBack(1, ThrowingMoveObj{});
+            v.EmplaceBack(2, ThrowingMoveObj{});
+            v.Get<1>(0).value = "x";
+            v.Reserve(2);
+            // Столбец ThrowingMoveObj копируется, а Obj перемещается
+            v.Reserve(10);
+            assert(v.Get<0>(1).id == 2 && v.Get<1>(0).value == "x");
+
+            v.Get<0>(0).throw_on_copy = true;
+            try {
+                SoaVector<Obj, ThrowingMoveObj> copy(v);
+                assert(false);
+            } catch (const std::runtime_error&) {
+            }
+            Obj::default_construction_throw_countdown = 3;
+            try {
+                v.Resize(5);
+                assert(false);
+            } catch (const std::runtime_error&) {
+            }
+            assert(v.Size() == 2);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        // Некопируемый столбец с выбрасывающим перемещением переносится с откатом, а не в noexcept-проходе
+        struct MoveOnly {
+            explicit MoveOnly(int value)
+                : value(value) {
+            }
+            MoveOnly(MoveOnly&& other) noexcept(false)
+                : value(other.value) {
+                if (other.value < 0) {
+                    throw std::runtime_error("Oops");
+                }
+            }
+            int value;
+        };
+        Obj::ResetCounters();
+        {
+            SoaVector<Obj, MoveOnly> v;
+            v.EmplaceBack(1, MoveOnly(1));
+            v.EmplaceBack(2, MoveOnly(2));
+            v.Reserve(8);
+            assert(v.Get<1>(1).value == 2);
+            v.Get<1>(1).value = -2;
+            const size_t capacity = v.Capacity();
+            try {
+                v.Reserve(100);
+                assert(false);
+            } catch (const std::runtime_error&) {
+            }
+            assert(v.Size() == 2 && v.Capacity() == capacity && v.Get<0>(1).id == 2);
+            assert(Obj::GetAliveObjectCount() == 2);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+}
+
+void Test25() {
+    using namespace std::literals;
+    {
+        Vector<std::string> v;
+        assert(v.TryReserve(4));
+        assert(v.Capacity() >= 4);
+        assert(v.TryPushBack("a"s));
+        for (size_t i = 1; i < 100; ++i) {
+            // Аргумент ссылается на элемент вектора, который переедет в новый буфер
+            assert(v.TryPushBack(v[0]));
+        }
+        assert(v.Size() == 100 && v[99] == "a"s);
+        std::string* s = v.TryEmplaceBack(3, 'b');
+        assert(s == &v[100] && *s == "bbb"s);
+        assert(!v.TryReserve(v.MaxSize() + 1));
+        assert(v.Size() == 101);
+    }
+    {
+        alignas(int) std::byte buffer[16 * sizeof(int)];
+        Vector<int, BumpAllocator<int>> v{BumpAllocator<int>(buffer, sizeof(buffer))};
+        assert(!v.TryReserve(17));
+        assert(v.Capacity() == 0);
+        assert(v.TryReserve(16));
+        for (int i = 0; i < 16; ++i) {
+            assert(v.TryPushBack(i));
+        }
+        const int* data = v.Data();
+        // Для следующего элемента памяти в буфере уже не хватает
+        assert(v.TryEmplaceBack(16) == nullptr);
+        assert(!v.TryPushBack(16));
+        assert(v.Size() == 16 && v.Data() == data && v[15] == 15);
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v;
+        for (int i = 0; i < 10; ++i) {
+            assert(v.TryEmplaceBack(i) != nullptr);
+        }
+        assert(v.Size() == 10 && v[9].id == 9);
+        Obj::default_construction_throw_countdown = 1;
+        try {
+            v.TryEmplaceBack();
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == 10);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+void Test26() {
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(5);
+        Vector<Obj> w(3);
+        v = std::move(w);
+        assert(v.Size() == 3 && w.Size() == 0);
+        assert(Obj::GetAliveObjectCount() == 3);
+        Vector<Obj>& same = v;
+        v = std::move(same);
+        assert(v.Size() == 3);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        CountingResource resource;
+        {
+            pmr::Vector<std::string> v(&resource);
+            for (int i = 0; i < 10; ++i) {
+                pmr::Vector<std::string> w(&resource);
+                w.Resize(4);
+                v = std::move(w);
+            }
+            assert(v.Size() == 4);
+        }
+        assert(resource.num_allocated == resource.num_deallocated);
+    }
+    {
+        // Производитель и потребитель обмениваются двумя буферами без новых выделений
+        CountingResource resource;
+        pmr::Vector<int> producer(&resource);
+        pmr::Vector<int> consumer(&resource);
+        producer.Reserve(64);
+        consumer.Reserve(16);
+        const int num_allocated = resource.num_allocated;
+        for (int round = 0; round < 10; ++round) {
+            for (int i = 0; i < 10; ++i) {
+                producer.PushBack(round * 10 + i);
+            }
+            consumer.Recycle(std::move(producer));
+            assert(producer.Size() == 0 && consumer.Size() == 10);
+            assert(consumer[0] == round * 10 && consumer[9] == round * 10 + 9);
+            assert(consumer.Capacity() == 64 && producer.Capacity() == 16);
+        }
+        assert(resource.num_allocated == num_allocated);
+    }
+    {
+        Obj::ResetCounters();
+        SmallVector<Obj, 2> small;
+        small.EmplaceBack(1);
+        Vector<ThrowingMoveObj> big;
+        big.Reserve(8);
+        Vector<ThrowingMoveObj> other(3);
+        big.Recycle(std::move(other));
+        assert(big.Size() == 3 && big.Capacity() == 8 && other.Size() == 0);
+        SmallVector<Obj, 2> heap(5);
+        small.Recycle(std::move(heap));
+        assert(small.Size() == 5 && heap.Size() == 0);
+        heap.EmplaceBack(7);
+        small.Recycle(std::move(heap));
+        assert(small.Size() == 1 && small[0].id == 7 && heap.Size() == 0);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+void Test27() {
+    using namespace std::literals;
+    {
+        FlatSet<int> set{5, 1, 3, 3, 9, 1};
+        assert(set.Size() == 4);
+        assert(std::is_sorted(set.begin(), set.end()));
+        assert(set.Contains(3) && !set.Contains(4));
+        assert(*set.LowerBound(4) == 5 && *set.UpperBound(5) == 9);
+        assert(set.LowerBound(10) == set.end());
+        assert(set.Insert(4).second && !set.Insert(4).second);
+        assert(set.Erase(1) == 1 && set.Erase(1) == 0);
+        const std::vector<int> batch{8, 2, 9, 0, 2, 7};
+        set.Insert(batch.begin(), batch.end());
+        assert((set == FlatSet<int>{0, 2, 3, 4, 5, 7, 8, 9}));
+        // Пакет, целиком лежащий правее существующих ключей, не сливается
+        set.Insert({10, 12, 11, 10});
+        assert((set == FlatSet<int>{0, 2, 3, 4, 5, 7, 8, 9, 10, 11, 12}));
+    }
+    {
+        // Оба варианта поиска находят каждый ключ и каждую позицию между ключами
+        Vector<int> keys;
+        for (int i = 0; i < 100; ++i) {
+            keys.PushBack(i * 2);
+        }
+        FlatSet<int, std::less<int>, BinarySearch> binary(SORTED_UNIQUE, keys);
+        FlatSet<int, std::less<int>, BranchlessSearch> branchless(SORTED_UNIQUE, keys.begin(), keys.end());
+        for (int key = -1; key <= 200; ++key) {
+            const int* expected = std::lower_bound(keys.begin(), keys.end(), key);
+            assert(binary.LowerBound(key) - binary.begin() == expected - keys.begin());
+            assert(branchless.LowerBound(key) - branchless.begin() == expected - keys.begin());
+            assert(branchless.Contains(key) == (key >= 0 && key < 200 && key % 2 == 0));
+        }
+        const Vector<int> extracted = branchless.Extract();
+        assert(extracted.Size() == 100 && branchless.Size() == 0);
+    }
+    {
+        FlatSet<std::string, std::greater<std::string>> set;
+        const std::string sorted[] = {"c"s, "a"s};
+        set.Insert(SORTED_UNIQUE, std::begin(sorted), std::end(sorted));
+        set.Emplace(3, 'b');
+        assert(set.Size() == 3 && set[0] == "c"s && set[1] == "bbb"s && set[2] == "a"s);
+    }
+    {
+        FlatMap<std::string, int> map{{"b"s, 2}, {"a"s, 1}, {"b"s, 3}};
+        assert(map.Size() == 2 && map.At("b"s) == 2);
+        map["c"s] = 3;
+        ++map["a"s];
+        assert(map.At("a"s) == 2 && map.At("c"s) == 3);
+        assert(!map.TryEmplace("a"s, 10).second && map.At("a"s) == 2);
+        assert(!map.InsertOrAssign("a"s, 10).second && map.At("a"s) == 10);
+        assert(map.Insert({"d"s, 4}).second);
+        try {
+            map.At("z"s);
+            assert(false);
+        } catch (const std::out_of_range&) {
+        }
+        const std::vector<std::pair<std::string, int>> batch{{"f"s, 6}, {"a"s, 0}, {"e"s, 5}};
+        map.Insert(batch.begin(), batch.end());
+        assert(map.Size() == 6 && map.At("a"s) == 10 && map.At("e"s) == 5);
+        assert(map.begin()->first == "a"s && (map.end() - 1)->first == "f"s);
+        assert(map.Erase("b"s) == 1 && map.Find("b"s) == map.end());
+        map.Erase(map.Find("f"s));
+        assert(map.Size() == 4 && !map.Contains("f"s));
+    }
+}
+
+void Test28() {
+    using namespace std::literals;
+    {
+        RingVector<int> ring;
+        ring.Reserve(4);
+        ring.PushBack(2);
+        ring.PushBack(3);
+        ring.PushFront(1);
+        ring.PushFront(0);
+        assert(ring.Size() == 4 && ring.Capacity() == 4);
+        assert(!ring.IsLinear());
+        assert(std::equal(ring.begin(), ring.end(), std::begin({0, 1, 2, 3})));
+        // Очередь: элементы добавляются в конец и забираются из начала, не выходя за вместимость
+        for (int i = 4; i < 100; ++i) {
+            assert(ring.Front() == i - 4);
+            ring.PopFront();
+            ring.PushBack(i);
+            assert(ring.Back() == i && ring.Size() == 4 && ring.Capacity() == 4);
+        }
+        const int* data = ring.Linearize();
+        assert(ring.IsLinear() && data[0] == 96 && data[3] == 99);
+        ring.PopBack();
+        ring.PopFront();
+        assert(ring.Size() == 2 && ring[0] == 97 && ring[1] == 98);
+        std::sort(ring.begin(), ring.end(), std::greater<int>());
+        assert(ring[0] == 98);
+    }
+    {
+        // Рост разворачивает кольцо, переходящее через конец буфера
+        RingVector<std::string> ring;
+        for (int i = 0; i < 8; ++i) {
+            ring.PushBack(std::to_string(i));
+        }
+        ring.PopFront();
+        ring.PopFront();
+        ring.PushBack("8"s);
+        ring.PushBack("9"s);
+        assert(!ring.IsLinear());
+        ring.PushFront(ring.Back());
+        assert(ring.Size() == 9 && ring.Front() == "9"s && ring[1] == "2"s && ring.Back() == "9"s);
+        ring.PushBack(ring.Front());
+        RingVector<std::string> copy(ring);
+        assert(std::equal(copy.begin(), copy.end(), ring.begin(), ring.end()));
+        RingVector<std::string> moved(std::move(copy));
+        assert(moved.Size() == 10 && copy.Size() == 0);
+        copy = moved;
+        moved = std::move(ring);
+        assert(moved.Size() == 10 && copy.Size() == 10);
+    }
+    {
+        Obj::ResetCounters();
+        RingVector<ThrowingMoveObj> throwing;
+        throwing.PushFront(ThrowingMoveObj{});
+        throwing.PushFront(ThrowingMoveObj{});
+        throwing.PushBack(ThrowingMoveObj{});
+        assert(throwing.Size() == 3);
+        RingVector<Obj> ring;
+        ring.Reserve(2);
+        ring.EmplaceBack(1);
+        ring.EmplaceFront(0);
+        Obj::default_construction_throw_countdown = 1;
+        try {
+            ring.EmplaceFront();
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(ring.Size() == 2 && ring[0].id == 0 && ring[1].id == 1);
+        ring.Clear();
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        // Разорванное кольцо с любым сдвигом и заполнением выпрямляется на месте без выделения памяти
+        CountingResource resource;
+        for (size_t size = 1; size <= 8; ++size) {
+            for (size_t shift = 0; shift < 8; ++shift) {
+                RingVector<std::string, std::pmr::polymorphic_allocator<std::string>> strings(&resource);
+                RingVector<int, std::pmr::polymorphic_allocator<int>> ints(&resource);
+                strings.Reserve(8);
+                ints.Reserve(8);
+                for (size_t i = 0; i < shift; ++i) {
+                    strings.PushBack(""s);
+                    strings.PopFront();
+                    ints.PushBack(0);
+                    ints.PopFront();
+                }
+                for (size_t i = 0; i < size; ++i) {
+                    strings.PushBack(std::string(20, static_cast<char>('a' + i)));
+                    ints.PushBack(static_cast<int>(i));
+                }
+                const int num_allocated = resource.num_allocated;
+                const std::string* first_string = strings.Linearize();
+                const int* first_int = ints.Linearize();
+                assert(resource.num_allocated == num_allocated && strings.Capacity() == 8);
+                assert(strings.IsLinear() && ints.IsLinear());
+                for (size_t i = 0; i < size; ++i) {
+                    assert(first_string[i] == std::string(20, static_cast<char>('a' + i)));
+                    assert(first_int[i] == static_cast<int>(i));
+                }
+            }
+        }
+        Obj::ResetCounters();
+        {
+            RingVector<Obj> objects;
+            objects.Reserve(4);
+            objects.EmplaceBack(1);
+            objects.EmplaceBack(2);
+            objects.EmplaceBack(3);
+            objects.PopFront();
+            objects.PopFront();
+            objects.EmplaceBack(4);
+            objects.EmplaceBack(5);
+            assert(!objects.IsLinear());
+            const Obj* first = objects.Linearize();
+            assert(first[0].id == 3 && first[2].id == 5 && Obj::GetAliveObjectCount() == 3);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        // Буфер с другим аллокатором нельзя забрать, поэтому элементы перемещаются по одному
+        CountingResource first_resource;
+        CountingResource second_resource;
+        {
+            RingVector<std::string, std::pmr::polymorphic_allocator<std::string>> lhs(&first_resource);
+            RingVector<std::string, std::pmr::polymorphic_allocator<std::string>> rhs(&second_resource);
+            lhs.PushBack("a"s);
+            for (int i = 0; i < 5; ++i) {
+                rhs.PushFront(std::to_string(i));
+            }
+            lhs = std::move(rhs);
+            assert(lhs.GetAllocator().resource() == &first_resource);
+            assert(lhs.Size() == 5 && lhs.Front() == "4"s && lhs.Back() == "0"s);
+        }
+        assert(first_resource.num_allocated == first_resource.num_deallocated);
+        assert(second_resource.num_allocated == second_resource.num_deallocated);
+    }
+    {
+        // Если перенос второй части разорванного кольца выбросил исключение,
+        // уже перенесённая первая часть уничтожается
+        struct MoveOnly {
+            explicit MoveOnly(int id)
+                : obj(id) {
+            }
+            MoveOnly(MoveOnly&& other) noexcept(false)
+                : obj(other.obj.id) {
+                if (other.throw_on_move) {
+                    throw std::runtime_error("Oops");
+                }
+            }
+            Obj obj;
+            bool throw_on_move = false;
+        };
+        Obj::ResetCounters();
+        {
+            RingVector<MoveOnly> ring;
+            ring.Reserve(4);
+            ring.EmplaceBack(1);
+            ring.EmplaceBack(2);
+            ring.EmplaceBack(3);
+            ring.PopFront();
+            ring.PopFront();
+            ring.EmplaceBack(4);
+            ring.EmplaceBack(5);
+            assert(!ring.IsLinear());
+            ring.Back().throw_on_move = true;
+            try {
+                ring.Reserve(8);
+                assert(false);
+            } catch (const std::runtime_error&) {
+            }
+            assert(ring.Size() == 3 && ring.Capacity() == 4);
+            assert(Obj::GetAliveObjectCount() == 3);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+}
+
+void Test29() {
+    using namespace std::literals;
+    {
+        // Блок со счётчиком ссылок выделяется тем же ресурсом, что и элементы
+        using PmrCow = CowVector<int, std::pmr::polymorphic_allocator<int>>;
+        CountingResource resource;
+        {
+            PmrCow::container_type elements(&resource);
+            elements.Reserve(4);
+            elements.PushBack(1);
+            const int num_allocated = resource.num_allocated;
+            PmrCow snapshot(std::move(elements));
+            assert(resource.num_allocated == num_allocated + 1);
+            PmrCow copy(snapshot);
+            assert(resource.num_allocated == num_allocated + 1);
+            // Отделённая копия получает новый блок и новый буфер элементов
+            copy.PushBack(2);
+            assert(resource.num_allocated == num_allocated + 3);
+            assert(copy.Size() == 2 && snapshot.Size() == 1);
+        }
+        assert(resource.num_allocated == resource.num_deallocated);
+    }
+    {
+        CowVector<std::string> snapshot{"a"s, "b"s, "c"s};
+        const std::string* data = snapshot.Data();
+        CowVector<std::string> copy(snapshot);
+        assert(copy.Data() == data && snapshot.UseCount() == 2 && copy.IsShared());
+        // Изменение отделяет копию, не затрагивая исходный вектор
+        copy.PushBack("d"s);
+        assert(copy.Data() != data && copy.Size() == 4 && !copy.IsShared());
+        assert(snapshot.Data() == data && snapshot.Size() == 3 && snapshot.UseCount() == 1);
+        const std::string* copy_data = copy.Data();
+        copy.PushBack("e"s);
+        assert(copy.Data() == copy_data);
+        copy.Erase(copy.begin());
+        assert(copy[0] == "b"s && copy.Size() == 4);
+        copy = snapshot;
+        copy.GetMutable(1) = "x"s;
+        assert(copy[1] == "x"s && snapshot[1] == "b"s);
+        copy.Insert(copy.begin(), "z"s);
+        assert(copy.Size() == 4 && copy[0] == "z"s);
+        CowVector<std::string> shared(snapshot);
+        shared.Clear();
+        assert(shared.Size() == 0 && snapshot.Size() == 3 && !snapshot.IsShared());
+    }
+    {
+        // Аргумент ссылается на элемент разделяемого блока, который другой владелец отпускает
+        // одновременно со вставкой: прежний блок должен жить, пока новый элемент не создан
+        const std::string long_value(100, 'x');
+        for (int round = 0; round < 200; ++round) {
+            CowVector<std::string> v{long_value};
+            auto* other = new CowVector<std::string>(v);
+            std::atomic<bool> start = false;
+            std::thread releaser([&] {
+                while (!start) {
+                }
+                delete other;
+            });
+            start = true;
+            if (round % 2 == 0) {
+                v.EmplaceBack(v[0]);
+            } else {
+                v.Insert(v.begin(), v[0]);
+            }
+            releaser.join();
+            assert(v.Size() == 2 && v[0] == long_value && v[1] == long_value);
+        }
+    }
+    {
+        Vector<int> values;
+        values.Resize(1000);
+        for (int i = 0; i < 1000; ++i) {
+            values[i] = i;
+        }
+        const CowVector<int> snapshot(std::move(values));
+        std::vector<std::thread> readers;
+        std::atomic<int> num_correct = 0;
+        for (int t = 0; t < 4; ++t) {
+            readers.emplace_back([snapshot, &num_correct] {
+                for (int round = 0; round < 100; ++round) {
+                    CowVector<int> local(snapshot);
+                    num_correct += local[999] == 999;
+                }
+                CowVector<int> own(snapshot);
+                own.Edit()[0] = -1;
+                num_correct += own[0] == -1 && snapshot[0] == 0;
+            });
+        }
+        for (std::thread& reader : readers) {
+            reader.join();
+        }
+        assert(num_correct == 404);
+        assert(snapshot[0] == 0 && snapshot.UseCount() == 1);
+    }
+    assert(CowVector<int>().Size() == 0);
+}
+
+// Таблица квадратов, построенная при компиляции
+constexpr StaticVector<int, 8> MakeSquares() {
+    StaticVector<int, 8> squares;
+    for (int i = 0; i < 6; ++i) {
+        squares.PushBack(i * i);
+    }
+    squares.Erase(squares.begin());
+    squares.Insert(squares.begin(), -1);
+    squares.PopBack();
+    return squares;
+}
+
+void Test30() {
+    using namespace std::literals;
+    {
+        constexpr StaticVector<int, 8> squares = MakeSquares();
+        static_assert(squares.Size() == 5 && squares[0] == -1 && squares[1] == 1 && squares[4] == 16);
+        static_assert(StaticVector<int, 4>{1, 2} == StaticVector<int, 4>{1, 2});
+        static_assert(std::is_trivially_destructible_v<StaticVector<int, 4>>);
+        static_assert(std::is_trivially_copyable_v<StaticVector<int, 4>>);
+        StaticVector<int, 4> v(2);
+        assert(v.Size() == 2 && v[0] == 0);
+        assert(v.TryPushBack(3) && v.TryPushBack(4));
+        assert(!v.TryPushBack(5) && v.TryEmplaceBack(5) == nullptr && v.Size() == 4);
+        try {
+            v.PushBack(5);
+            assert(false);
+        } catch (const std::length_error&) {
+        }
+        const int more[] = {7, 8};
+        v.Erase(v.begin() + 3);
+        try {
+            v.Insert(v.begin(), std::begin(more), std::end(more));
+            assert(false);
+        } catch (const std::length_error&) {
+        }
+        assert(v.Size() == 3);
+        // Итератор ввода переполняет вектор посреди вставки, и добавленные элементы удаляются
+        std::istringstream input("7 8");
+        try {
+            v.Insert(v.begin(), std::istream_iterator<int>(input), std::istream_iterator<int>());
+            assert(false);
+        } catch (const std::length_error&) {
+        }
+        assert(v.Size() == 3 && v[0] == 0 && v[2] == 3);
+    }
+    {
+        Obj::ResetCounters();
+        {
+            StaticVector<Obj, 3> objects(2);
+            objects.EmplaceBack(5);
+            assert(Obj::GetAliveObjectCount() == 3);
+            StaticVector<Obj, 3> copy(objects);
+            assert(Obj::GetAliveObjectCount() == 6 && copy[2].id == 5);
+            copy.Erase(copy.begin());
+            objects = copy;
+            assert(objects.Size() == 2 && objects[1].id == 5);
+            objects.Emplace(objects.begin(), 1);
+            assert(objects[0].id == 1 && objects[2].id == 5);
+            copy = std::move(objects);
+            assert(copy.Size() == 3);
+            copy.Clear();
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+        {
+            // Исключение при копировании второго элемента отменяет всю вставку
+            Obj source[2];
+            source[1].throw_on_copy = true;
+            StaticVector<Obj, 3> objects(1);
+            try {
+                objects.Insert(objects.begin(), std::begin(source), std::end(source));
+                assert(false);
+            } catch (const std::runtime_error&) {
+            }
+            assert(objects.Size() == 1 && Obj::GetAliveObjectCount() == 3);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+        StaticVector<std::string, 4> strings{"a"s, "b"s};
+        strings.Insert(strings.begin() + 1, strings[1]);
+        assert((strings == StaticVector<std::string, 4>{"a"s, "b"s, "b"s}));
+    }
+}
+
+void Test31() {
+    using namespace std::literals;
+    {
+        // Буфер, заполненный в обход вектора (например, через recv), переходит к нему без копирования
+        std::allocator<int> alloc;
+        int* buffer = alloc.allocate(16);
+        for (int i = 0; i < 10; ++i) {
+            buffer[i] = i;
+        }
+        Vector<int> v(3);
+        v.Adopt(buffer, 10, 16);
+        assert(v.Data() == buffer && v.Size() == 10 && v.Capacity() == 16 && v[9] == 9);
+        v.PushBack(10);
+        assert(v.Data() == buffer && std::size(v) == 11 && std::data(v) == buffer);
+        const ReleasedBuffer<int> released = v.Release();
+        assert(released.ptr == buffer && released.size == 11 && released.capacity == 16);
+        assert(v.Size() == 0 && v.Capacity() == 0 && v.Data() == nullptr);
+        alloc.deallocate(released.ptr, released.capacity);
+    }
+    {
+        MallocAllocator<std::string> alloc;
+        std::string* buffer = alloc.allocate(4);
+        std::uninitialized_fill_n(buffer, 2, "x"s);
+        Vector<std::string, MallocAllocator<std::string>> v;
+        v.Adopt(buffer, 2, 4);
+        v.PushBack("y"s);
+        assert(v.Size() == 3 && v[0] == "x"s && v[2] == "y"s);
+        v.Adopt(nullptr, 0, 0);
+        assert(v.Size() == 0 && v.Capacity() == 0);
+    }
+    {
+        Obj::ResetCounters();
+        SmallVector<Obj, 4> small;
+        small.EmplaceBack(1);
+        small.EmplaceBack(2);
+        // Элементы из встроенного буфера переносятся в кучу
+        const ReleasedBuffer<Obj> released = small.Release();
+        assert(released.size == 2 && released.ptr[1].id == 2 && small.Size() == 0);
+        assert(Obj::GetAliveObjectCount() == 2);
+        SmallVector<Obj, 4> other;
+        other.Adopt(released.ptr, released.size, released.capacity);
+        assert(other.Size() == 2 && other.Data() == released.ptr);
+        assert(small.Release().ptr == nullptr);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+void Test32() {
+    struct Record {
+        uint32_t id;
+        double value;
+    };
+    const std::string path = "/tmp/advanced_vector_test32_" + std::to_string(getpid()) + ".bin";
+    Vector<Record> records;
+    for (uint32_t i = 0; i < 1000; ++i) {
+        records.PushBack({i, i * 0.5});
+    }
+    SegmentedVector<Record, 64> segmented;
+    for (uint32_t i = 1000; i < 1300; ++i) {
+        segmented.PushBack({i, i * 0.5});
+    }
+    StaticVector<Record, 4> header{{7, 7.0}};
+    {
+        const int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        assert(fd >= 0);
+        WriteTo(fd, header);
+        IoVector slices;
+        slices.Add(records);
+        slices.Add(segmented);
+        slices.Add(records.Data(), 0);
+        assert(slices.Size() == 1 + (300 + 63) / 64);
+        assert(slices.GetBytes() == 1300 * sizeof(Record));
+        slices.WriteTo(fd);
+        // Обрывок элемента в конце файла
+        const char tail[3] = {};
+        WriteTo(fd, tail, 3);
+        close(fd);
+    }
+    {
+        const int fd = open(path.c_str(), O_RDONLY);
+        assert(fd >= 0);
+        Vector<Record> loaded;
+        assert(ReadFrom(fd, loaded, 1) == 1 && loaded[0].id == 7);
+        assert(ReadFrom(fd, loaded, 1000) == 1000 && loaded.Size() == 1001);
+        assert(loaded[1000].id == 999 && loaded[1000].value == 999 * 0.5);
+        try {
+            ReadFrom(fd, loaded, 1000);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(loaded.Size() == 1301 && loaded[1300].id == 1299);
+        assert(ReadFrom(fd, loaded, 10) == 0 && loaded.Size() == 1301);
+        close(fd);
+    }
+    try {
+        Vector<Record> loaded;
+        ReadFrom(-1, loaded, 10);
+        assert(false);
+    } catch (const std::system_error&) {
+    }
+    unlink(path.c_str());
+}
+
+void Test33() {
+    using namespace std::literals;
+    // Маленькие части, чтобы алгоритмы выполнялись в нескольких потоках и на небольших векторах
+    const ParallelPolicy policy{4, 1000};
+    {
+        Vector<int> v(10007, DEFAULT_INIT);
+        uint32_t seed = 12345;
+        for (int& value : v) {
+            seed = seed * 1664525 + 1013904223;
+            value = static_cast<int>(seed);
+        }
+        Vector<int> expected(v);
+        std::sort(expected.begin(), expected.end());
+        Vector<int> radix(v);
+        RadixSort(radix);
+        assert(std::equal(radix.begin(), radix.end(), expected.begin(), expected.end()));
+        ParallelSort(v, std::less<>{}, policy);
+        assert(std::equal(v.begin(), v.end(), expected.begin(), expected.end()));
+        ParallelSort(v, std::greater<>{}, policy);
+        assert(std::is_sorted(v.begin(), v.end(), std::greater<>{}));
+    }
+    {
+        Vector<double> v(3000, DEFAULT_INIT);
+        for (size_t i = 0; i < v.Size(); ++i) {
+            v[i] = (i % 2 == 0 ? -1.0 : 1.0) * static_cast<double>((i * 7919) % 1013) / 8;
+        }
+        ParallelSort(v, std::less<>{}, policy);
+        assert(std::is_sorted(v.begin(), v.end()));
+    }
+    {
+        Vector<std::string> v;
+        for (int i = 0; i < 5000; ++i) {
+            v.PushBack(std::to_string((i * 31) % 5000));
+        }
+        ParallelSort(v, std::less<>{}, policy);
+        assert(std::is_sorted(v.begin(), v.end()) && v[0] == "0"s && v.Size() == 5000);
+    }
+    {
+        Vector<int> input(10000, DEFAULT_INIT);
+        std::iota(input.begin(), input.end(), 0);
+        Vector<int64_t> squares;
+        Transform(input, squares, [](int x) {
+            return int64_t{x} * x;
+        }, policy);
+        assert(squares.Size() == input.Size() && squares[9999] == 9999LL * 9999);
+        assert(Reduce(input, int64_t{0}, std::plus<>{}, policy) == 9999LL * 10000 / 2);
+        assert(Reduce(input, 0, std::plus<>{}, policy) == 9999 * 10000 / 2);
+        assert(Reduce(input, 0, [](int lhs, int rhs) {
+            return std::max(lhs, rhs);
+        }, policy) == 9999);
+        assert(Reduce(Vector<int>(), 7) == 7);
+        // Некоммутативная операция: части объединяются по порядку
+        Vector<std::string> words;
+        for (int i = 0; i < 3000; ++i) {
+            words.PushBack(std::to_string(i % 10));
+        }
+        const std::string joined = std::accumulate(words.begin(), words.end(), "<"s);
+        assert(Reduce(words, "<"s, std::plus<>{}, ParallelPolicy{4, 100}) == joined);
+        // Свёртка в аккумулятор другого типа выполняется последовательно
+        assert(Reduce(words, size_t{1}, [](size_t total, const std::string& word) {
+            return total + word.size();
+        }, ParallelPolicy{4, 100}) == 3001);
+        // Аккумулятор без конструктора по умолчанию тоже сворачивается последовательно
+        struct NoDefaultSum {
+            NoDefaultSum(int value)
+                : value(value) {
+            }
+            int value;
+        };
+        assert(Reduce(input, NoDefaultSum(0), [](const NoDefaultSum& lhs, const NoDefaultSum& rhs) {
+            return NoDefaultSum(lhs.value + rhs.value);
+        }, policy).value == 9999 * 10000 / 2);
+        // Преобразование на месте
+        Transform(input, input, [](int x) {
+            return -x;
+        }, policy);
+        assert(input[5] == -5);
+        assert(FindIf(input, [](int x) {
+            return x < -7000;
+        }, policy) == input.begin() + 7001);
+        assert(FindIf(input, [](int x) {
+            return x > 0;
+        }, policy) == input.end());
+        const Vector<int>& const_input = input;
+        assert(FindIf(const_input, [](int x) {
+            return x == -3;
+        }) == const_input.begin() + 3);
+    }
+    {
+        StaticVector<float, 100> values;
+        for (int i = 0; i < 100; ++i) {
+            values.PushBack(static_cast<float>(i));
+        }
+        assert(Reduce(values, 0.0f) == 4950.0f);
+        Vector<std::string> names;
+        Transform(values, names, [](float x) {
+            return std::to_string(static_cast<int>(x));
+        });
+        assert(names.Size() == 100 && names[42] == "42"s);
+        assert(FindIf(names, [](const std::string& name) {
+            return name.size() == 2;
+        }) == names.begin() + 10);
+    }
+}
+
+void Test34() {
+#if VECTOR_DEBUG
+    // Проверка, что операция аварийно завершает процесс: проверки отладочного режима вызывают
+    // std::abort, а AddressSanitizer завершает процесс с ненулевым кодом
+    const auto check_aborts = [](auto operation) {
+        const pid_t pid = fork();
+        if (pid == 0) {
+            std::freopen("/dev/null", "w", stderr);
+            operation();
+            _exit(0);
+        }
+        int status = 0;
+        waitpid(pid, &status, 0);
+        assert(!WIFEXITED(status) || WEXITSTATUS(status) != 0);
+    };
+    {
+        Vector<int> v;
+        v.Reserve(4);
+        v.PushBack(1);
+        const size_t generation = v.GetGeneration();
+        Vector<int>::iterator it = v.begin();
+        v.PushBack(2);
+        assert(v.GetGeneration() == generation && *it == 1);
+        v.Reserve(100);
+        assert(v.GetGeneration() != generation);
+        check_aborts([&it] {
+            static_cast<void>(*it);
+        });
+        it = v.begin() + 1;
+        v.PopBack();
+        check_aborts([&it] {
+            static_cast<void>(*it);
+        });
+        // Итераторы из указателей не проверяются
+        Vector<int>::const_iterator raw = v.Data();
+        assert(*raw == 1);
+    }
+#if VECTOR_ANNOTATE_CONTAINER
+    {
+        Vector<int> v;
+        v.Reserve(16);
+        v.PushBack(1);
+        assert(!__asan_address_is_poisoned(v.Data()) && __asan_address_is_poisoned(v.Data() + 1));
+        v.Resize(10);
+        assert(!__asan_address_is_poisoned(v.Data() + 9) && __asan_address_is_poisoned(v.Data() + 10));
+        v.Erase(v.begin(), v.begin() + 5);
+        assert(__asan_address_is_poisoned(v.Data() + 5));
+        const ReleasedBuffer<int> released = v.Release();
+        assert(!__asan_address_is_poisoned(released.ptr + 15));
+        v.Adopt(released.ptr, released.size, released.capacity);
+        assert(__asan_address_is_poisoned(v.Data() + 5));
+        check_aborts([&v] {
+            const volatile int value = v.Data()[v.Size()];
+            static_cast<void>(value);
+        });
     }
+#endif
+#else
+    // Вне отладочного режима итераторы остаются указателями
+    static_assert(std::is_same_v<Vector<int>::iterator, int*>);
+    static_assert(std::is_same_v<SmallVector<int, 4>::const_iterator, const int*>);
+#endif
 }
 
 int main() {
@@ -648,7 +2862,34 @@ int main() {
         Test4();
         Test5();
         Test6();
-        Benchmark();
+        Test7();
+        Test8();
+        Test9();
+        Test10();
+        Test11();
+        Test12();
+        Test13();
+        Test14();
+        Test15();
+        Test16();
+        Test17();
+        Test18();
+        Test19();
+        Test20();
+        Test21();
+        Test22();
+        Test23();
+        Test24();
+        Test25();
+        Test26();
+        Test27();
+        Test28();
+        Test29();
+        Test30();
+        Test31();
+        Test32();
+        Test33();
+        Test34();
     } catch (const std::exception& e) {
         std::cerr << e.what() << std::endl;
     }
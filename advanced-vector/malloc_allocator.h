@@ -0,0 +1,118 @@
+#pragma once
+#include "vector.h"
+
+#include <cstddef>
+#include <cstdlib>
+#include <limits>
+#include <new>
+
+#if defined(VECTOR_USE_JEMALLOC)
+#include <jemalloc/jemalloc.h>
+#elif defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+// Аллокатор поверх malloc/realloc. Округляет выделение до фактического размера блока, чтобы вектор
+// использовал всю оплаченную память, и позволяет переносить тривиально перемещаемые элементы через
+// realloc, который для больших блоков в glibc использует mremap и не копирует страницы.
+// С jemalloc (VECTOR_USE_JEMALLOC) размер блока вычисляется заранее через nallocx,
+// а расширение на месте выполняется через xallocx
+template <typename T>
+class MallocAllocator {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "malloc does not provide required alignment");
+
+public:
+    using value_type = T;
+
+    MallocAllocator() = default;
+
+    template <typename U>
+    MallocAllocator(const MallocAllocator<U>&) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        return allocate_at_least(n).ptr;
+    }
+
+    AllocationResult<T> allocate_at_least(size_t n) {
+#if defined(VECTOR_USE_JEMALLOC)
+        const size_t bytes = nallocx(GetBytes(n), 0);
+        void* ptr = bytes != 0 ? mallocx(bytes, 0) : nullptr;
+        if (ptr == nullptr) {
+            VECTOR_THROW(std::bad_alloc());
+        }
+        return {static_cast<T*>(ptr), bytes / sizeof(T)};
+#else
+        void* ptr = std::malloc(GetBytes(n));
+        if (ptr == nullptr) {
+            VECTOR_THROW(std::bad_alloc());
+        }
+        return ClaimUsableSize(ptr, n);
+#endif
+    }
+
+    void deallocate(T* ptr, size_t /*n*/) noexcept {
+        std::free(ptr);
+    }
+
+#if defined(VECTOR_USE_JEMALLOC)
+    size_t expand(T* ptr, size_t /*old_n*/, size_t n) noexcept {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            return 0;
+        }
+        const size_t bytes = xallocx(ptr, n * sizeof(T), 0, 0);
+        return bytes >= n * sizeof(T) ? bytes / sizeof(T) : 0;
+    }
+#endif
+
+    AllocationResult<T> reallocate(T* ptr, size_t /*old_n*/, size_t n) {
+#if defined(VECTOR_USE_JEMALLOC)
+        const size_t bytes = nallocx(GetBytes(n), 0);
+        void* new_ptr = bytes != 0 ? rallocx(ptr, bytes, 0) : nullptr;
+        if (new_ptr == nullptr) {
+            VECTOR_THROW(std::bad_alloc());
+        }
+        return {static_cast<T*>(new_ptr), bytes / sizeof(T)};
+#else
+        void* new_ptr = std::realloc(static_cast<void*>(ptr), GetBytes(n));
+        if (new_ptr == nullptr) {
+            VECTOR_THROW(std::bad_alloc());
+        }
+        return ClaimUsableSize(new_ptr, n);
+#endif
+    }
+
+    template <typename U>
+    bool operator==(const MallocAllocator<U>&) const noexcept {
+        return true;
+    }
+    template <typename U>
+    bool operator!=(const MallocAllocator<U>&) const noexcept {
+        return false;
+    }
+
+private:
+    static size_t GetBytes(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            VECTOR_THROW(std::bad_array_new_length());
+        }
+        return n * sizeof(T);
+    }
+
+#if !defined(VECTOR_USE_JEMALLOC)
+    // Закрепляет за вектором запас, оставшийся в блоке после выделения n элементов. Запас нельзя
+    // просто использовать, поэтому блок увеличивается через realloc, который в пределах блока
+    // не переносит данные
+    static AllocationResult<T> ClaimUsableSize(void* ptr, size_t n) noexcept {
+#if defined(__GLIBC__)
+        const size_t usable_count = malloc_usable_size(ptr) / sizeof(T);
+        if (usable_count > n) {
+            if (void* claimed = std::realloc(ptr, usable_count * sizeof(T)); claimed != nullptr) {
+                return {static_cast<T*>(claimed), usable_count};
+            }
+        }
+#endif
+        return {static_cast<T*>(ptr), n};
+    }
+#endif
+};
@@ -0,0 +1,326 @@
+#pragma once
+#include "vector.h"
+
+#include <cassert>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Режим открытия файла MappedVector
+enum class MapMode {
+    // Только чтение, страницы файла разделяются между процессами
+    READ_ONLY,
+    // Изменения записываются в файл
+    READ_WRITE,
+    // Изменения видны только этому объекту и не попадают в файл. Вместимость ограничена размером файла
+    COPY_ON_WRITE,
+};
+
+// Вектор тривиально копируемых элементов, хранящихся в отображённом в память файле.
+// Файл начинается с заголовка (сигнатура, версия, sizeof(T), число элементов), за которым
+// без преобразований следуют сами элементы, поэтому загрузка сводится к вызову mmap.
+// Файл с элементами не переносим между платформами с разным порядком байт или выравниванием
+template <typename T, typename GrowthPolicy = DoublingGrowth>
+class MappedVector {
+    static_assert(std::is_trivially_copyable_v<T>, "MappedVector requires trivially copyable elements");
+    static_assert(alignof(T) <= 64, "Elements must not require alignment stricter than the file header");
+
+public:
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    static constexpr uint64_t MAGIC = 0x31524f544345564dULL;  // "MVECTOR1"
+    static constexpr uint32_t VERSION = 1;
+
+    // Создаёт пустой файл по пути path, перезаписывая существующий, и открывает его на запись
+    static MappedVector Create(const std::string& path, size_t capacity = 0) {
+        const int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            VECTOR_THROW(std::system_error(errno, std::generic_category(), "Failed to create " + path));
+        }
+        MappedVector vector(fd, MapMode::READ_WRITE);
+        vector.Remap(GetFileSize(capacity));
+        Header& header = vector.GetHeader();
+        header.magic = MAGIC;
+        header.version = VERSION;
+        header.element_size = sizeof(T);
+        header.size = 0;
+        return vector;
+    }
+
+    // Открывает существующий файл, проверяя его заголовок
+    static MappedVector Open(const std::string& path, MapMode mode = MapMode::READ_ONLY) {
+        const int fd = open(path.c_str(), mode == MapMode::READ_WRITE ? O_RDWR : O_RDONLY);
+        if (fd < 0) {
+            VECTOR_THROW(std::system_error(errno, std::generic_category(), "Failed to open " + path));
+        }
+        MappedVector vector(fd, mode);
+        struct stat file_stat {};
+        if (fstat(fd, &file_stat) != 0) {
+            VECTOR_THROW(std::system_error(errno, std::generic_category(), "Failed to stat " + path));
+        }
+        const size_t file_size = static_cast<size_t>(file_stat.st_size);
+        if (file_size < HEADER_SIZE) {
+            VECTOR_THROW(std::runtime_error("File is too small to be a MappedVector: " + path));
+        }
+        vector.Map(file_size);
+        const Header& header = vector.GetHeader();
+        if (header.magic != MAGIC || header.version != VERSION) {
+            VECTOR_THROW(std::runtime_error("File is not a MappedVector: " + path));
+        }
+        if (header.element_size != sizeof(T)) {
+            VECTOR_THROW(std::runtime_error("Element size mismatch in " + path));
+        }
+        if (header.size > vector.capacity_) {
+            VECTOR_THROW(std::runtime_error("File is truncated: " + path));
+        }
+        vector.size_ = static_cast<size_t>(header.size);
+        return vector;
+    }
+
+    MappedVector(const MappedVector&) = delete;
+    MappedVector& operator=(const MappedVector&) = delete;
+
+    MappedVector(MappedVector&& other) noexcept
+        : fd_(std::exchange(other.fd_, -1))
+        , mode_(other.mode_)
+        , mapping_(std::exchange(other.mapping_, nullptr))
+        , mapping_size_(std::exchange(other.mapping_size_, 0))
+        , size_(std::exchange(other.size_, 0))
+        , capacity_(std::exchange(other.capacity_, 0)) {
+    }
+
+    MappedVector& operator=(MappedVector&& rhs) noexcept {
+        if (this != &rhs) {
+            Close();
+            fd_ = std::exchange(rhs.fd_, -1);
+            mode_ = rhs.mode_;
+            mapping_ = std::exchange(rhs.mapping_, nullptr);
+            mapping_size_ = std::exchange(rhs.mapping_size_, 0);
+            size_ = std::exchange(rhs.size_, 0);
+            capacity_ = std::exchange(rhs.capacity_, 0);
+        }
+        return *this;
+    }
+
+    ~MappedVector() {
+        Close();
+    }
+
+    iterator begin() noexcept {
+        return Data();
+    }
+    iterator end() noexcept {
+        return Data() + size_;
+    }
+    const_iterator begin() const noexcept {
+        return Data();
+    }
+    const_iterator end() const noexcept {
+        return Data() + size_;
+    }
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    T* Data() noexcept {
+        return mapping_ == nullptr ? nullptr : reinterpret_cast<T*>(mapping_ + HEADER_SIZE);
+    }
+
+    const T* Data() const noexcept {
+        return mapping_ == nullptr ? nullptr : reinterpret_cast<const T*>(mapping_ + HEADER_SIZE);
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return capacity_;
+    }
+
+    MapMode GetMode() const noexcept {
+        return mode_;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return Data()[index];
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return Data()[index];
+    }
+
+    // Увеличивает файл так, чтобы в нём помещалось new_capacity элементов
+    void Reserve(size_t new_capacity) {
+        if (new_capacity <= capacity_) {
+            return;
+        }
+        RequireGrowable();
+        Remap(GetFileSize(new_capacity));
+    }
+
+    // Новые элементы инициализируются нулями, которыми ftruncate заполняет файл,
+    // либо значением T{}
+    void Resize(size_t new_size) {
+        RequireWritable();
+        if (new_size > size_) {
+            Reserve(new_size);
+            std::uninitialized_value_construct_n(Data() + size_, new_size - size_);
+        }
+        SetSize(new_size);
+    }
+
+    void PushBack(const T& value) {
+        RequireWritable();
+        if (size_ == capacity_) {
+            // value может ссылаться на элемент, который переедет при переотображении
+            const T value_copy(value);
+            Reserve(GrowthPolicy::template NextCapacity<T>(capacity_, size_ + 1));
+            new (Data() + size_) T(value_copy);
+        } else {
+            new (Data() + size_) T(value);
+        }
+        SetSize(size_ + 1);
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        T value(std::forward<Args>(args)...);
+        PushBack(value);
+        return Data()[size_ - 1];
+    }
+
+    void PopBack() {
+        RequireWritable();
+        assert(size_ != 0);
+        SetSize(size_ - 1);
+    }
+
+    void Clear() {
+        RequireWritable();
+        SetSize(0);
+    }
+
+    // Сбрасывает изменённые страницы на диск. В режиме COPY_ON_WRITE ничего не делает
+    void Sync() {
+        if (mode_ == MapMode::READ_WRITE && mapping_ != nullptr) {
+            if (msync(mapping_, mapping_size_, MS_SYNC) != 0) {
+                VECTOR_THROW(std::system_error(errno, std::generic_category(), "msync failed"));
+            }
+        }
+    }
+
+private:
+    // Заголовок занимает целую кеш-линию, поэтому элементы выровнены не хуже, чем на 64 байта
+    struct Header {
+        uint64_t magic;
+        uint32_t version;
+        uint32_t element_size;
+        uint64_t size;
+    };
+
+    static constexpr size_t HEADER_SIZE = 64;
+    static_assert(sizeof(Header) <= HEADER_SIZE);
+
+    MappedVector(int fd, MapMode mode) noexcept
+        : fd_(fd)
+        , mode_(mode) {
+    }
+
+    static size_t GetFileSize(size_t capacity) {
+        if (capacity > (std::numeric_limits<off_t>::max() - HEADER_SIZE) / sizeof(T)) {
+            VECTOR_THROW(std::length_error("MappedVector is too long"));
+        }
+        return HEADER_SIZE + capacity * sizeof(T);
+    }
+
+    Header& GetHeader() noexcept {
+        return *reinterpret_cast<Header*>(mapping_);
+    }
+
+    const Header& GetHeader() const noexcept {
+        return *reinterpret_cast<const Header*>(mapping_);
+    }
+
+    void SetSize(size_t new_size) noexcept {
+        size_ = new_size;
+        GetHeader().size = new_size;
+    }
+
+    void RequireWritable() const {
+        if (mode_ == MapMode::READ_ONLY) {
+            VECTOR_THROW(std::logic_error("MappedVector is opened read-only"));
+        }
+    }
+
+    void RequireGrowable() const {
+        if (mode_ != MapMode::READ_WRITE) {
+            VECTOR_THROW(std::logic_error("Only a MappedVector opened for writing can grow"));
+        }
+    }
+
+    // Увеличивает файл до file_size байт и отображает его заново. Данные остаются в файле,
+    // поэтому элементы не копируются. Старое отображение снимается только после успешного
+    // создания нового
+    void Remap(size_t file_size) {
+        if (ftruncate(fd_, static_cast<off_t>(file_size)) != 0) {
+            VECTOR_THROW(std::system_error(errno, std::generic_category(), "ftruncate failed"));
+        }
+        Map(file_size);
+    }
+
+    void Map(size_t file_size) {
+        const int protection = mode_ == MapMode::READ_ONLY ? PROT_READ : PROT_READ | PROT_WRITE;
+        const int flags = mode_ == MapMode::READ_WRITE ? MAP_SHARED : MAP_PRIVATE;
+        void* mapping = mmap(nullptr, file_size, protection, flags, fd_, 0);
+        if (mapping == MAP_FAILED) {
+            VECTOR_THROW(std::system_error(errno, std::generic_category(), "mmap failed"));
+        }
+        Unmap();
+        mapping_ = static_cast<unsigned char*>(mapping);
+        mapping_size_ = file_size;
+        capacity_ = (file_size - HEADER_SIZE) / sizeof(T);
+    }
+
+    void Unmap() noexcept {
+        if (mapping_ != nullptr) {
+            munmap(mapping_, mapping_size_);
+            mapping_ = nullptr;
+            mapping_size_ = 0;
+            capacity_ = 0;
+        }
+    }
+
+    void Close() noexcept {
+        Unmap();
+        if (fd_ >= 0) {
+            close(fd_);
+            fd_ = -1;
+        }
+        size_ = 0;
+    }
+
+    int fd_ = -1;
+    MapMode mode_ = MapMode::READ_ONLY;
+    unsigned char* mapping_ = nullptr;
+    size_t mapping_size_ = 0;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+};
@@ -0,0 +1,160 @@
+#pragma once
+#include "vector.h"
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <new>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+// Аллокатор для очень больших векторов. Блоки меньше Threshold байт выделяются через malloc,
+// а начиная с Threshold память отображается напрямую через mmap, и ядру рекомендуется покрыть её
+// прозрачными огромными страницами (MADV_HUGEPAGE), что снижает число промахов TLB.
+// В Linux отображённый блок растёт и сжимается через mremap: страницы переназначаются, а не копируются,
+// а при сжатии хвостовые страницы сразу возвращаются системе
+template <typename T, size_t Threshold = size_t{32} << 20>
+class MmapAllocator {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "malloc does not provide required alignment");
+
+public:
+    using value_type = T;
+
+    static constexpr size_t THRESHOLD = Threshold;
+
+    template <typename U>
+    struct rebind {
+        using other = MmapAllocator<U, Threshold>;
+    };
+
+    MmapAllocator() = default;
+
+    template <typename U>
+    MmapAllocator(const MmapAllocator<U, Threshold>&) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        return allocate_at_least(n).ptr;
+    }
+
+    AllocationResult<T> allocate_at_least(size_t n) {
+        const size_t bytes = GetBytes(n);
+        if (!IsMapped(bytes)) {
+            void* ptr = std::malloc(bytes);
+            if (ptr == nullptr) {
+                VECTOR_THROW(std::bad_alloc());
+            }
+            return {static_cast<T*>(ptr), n};
+        }
+        const size_t mapped_bytes = GetMappedBytes(bytes);
+        void* ptr = mmap(nullptr, mapped_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ptr == MAP_FAILED) {
+            VECTOR_THROW(std::bad_alloc());
+        }
+        AdviseHugePages(ptr, mapped_bytes);
+        return {static_cast<T*>(ptr), GetMappedCount(n, mapped_bytes)};
+    }
+
+    void deallocate(T* ptr, size_t n) noexcept {
+        const size_t bytes = n * sizeof(T);
+        if (IsMapped(bytes)) {
+            munmap(ptr, GetMappedBytes(bytes));
+        } else {
+            std::free(ptr);
+        }
+    }
+
+#if defined(__linux__)
+    // Расширяет отображение на месте, если за ним свободно адресное пространство
+    size_t expand(T* ptr, size_t old_n, size_t n) noexcept {
+        const size_t old_bytes = old_n * sizeof(T);
+        if (!IsMapped(old_bytes) || n > std::numeric_limits<size_t>::max() / sizeof(T) - PAGE_SIZE) {
+            return 0;
+        }
+        const size_t old_mapped_bytes = GetMappedBytes(old_bytes);
+        const size_t mapped_bytes = GetMappedBytes(n * sizeof(T));
+        if (mremap(ptr, old_mapped_bytes, mapped_bytes, 0) == MAP_FAILED) {
+            return 0;
+        }
+        AdviseHugePages(ptr, mapped_bytes);
+        return GetMappedCount(n, mapped_bytes);
+    }
+#endif
+
+    // Переносит блок побайтово. Между отображёнными блоками страницы переназначаются без копирования
+    AllocationResult<T> reallocate(T* ptr, size_t old_n, size_t n) {
+        const size_t old_bytes = old_n * sizeof(T);
+        const size_t bytes = GetBytes(n);
+        if (!IsMapped(old_bytes) && !IsMapped(bytes)) {
+            void* new_ptr = std::realloc(static_cast<void*>(ptr), bytes);
+            if (new_ptr == nullptr) {
+                VECTOR_THROW(std::bad_alloc());
+            }
+            return {static_cast<T*>(new_ptr), n};
+        }
+#if defined(__linux__)
+        if (IsMapped(old_bytes) && IsMapped(bytes)) {
+            const size_t mapped_bytes = GetMappedBytes(bytes);
+            void* new_ptr = mremap(ptr, GetMappedBytes(old_bytes), mapped_bytes, MREMAP_MAYMOVE);
+            if (new_ptr == MAP_FAILED) {
+                VECTOR_THROW(std::bad_alloc());
+            }
+            AdviseHugePages(new_ptr, mapped_bytes);
+            return {static_cast<T*>(new_ptr), GetMappedCount(n, mapped_bytes)};
+        }
+#endif
+        // Блок переходит через порог, поэтому содержимое копируется в память другого вида
+        const AllocationResult<T> allocation = allocate_at_least(n);
+        std::memcpy(static_cast<void*>(allocation.ptr), static_cast<const void*>(ptr), std::min(old_bytes, bytes));
+        deallocate(ptr, old_n);
+        return allocation;
+    }
+
+    template <typename U>
+    bool operator==(const MmapAllocator<U, Threshold>&) const noexcept {
+        return true;
+    }
+    template <typename U>
+    bool operator!=(const MmapAllocator<U, Threshold>&) const noexcept {
+        return false;
+    }
+
+private:
+    static constexpr size_t PAGE_SIZE = 4096;
+    static constexpr size_t HUGE_PAGE_SIZE = size_t{2} << 20;
+
+    static size_t GetBytes(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T) - HUGE_PAGE_SIZE) {
+            VECTOR_THROW(std::bad_array_new_length());
+        }
+        return n * sizeof(T);
+    }
+
+    static bool IsMapped(size_t bytes) noexcept {
+        return bytes >= Threshold;
+    }
+
+    // Отображения от размера огромной страницы округляются до целого числа огромных страниц,
+    // чтобы ядро могло покрыть ими хвост блока. Размер отображения однозначно определяется
+    // числом байт, поэтому deallocate восстанавливает его по ёмкости
+    static size_t GetMappedBytes(size_t bytes) noexcept {
+        const size_t granularity = bytes >= HUGE_PAGE_SIZE ? HUGE_PAGE_SIZE : PAGE_SIZE;
+        return (bytes + granularity - 1) / granularity * granularity;
+    }
+
+    // Вектор получает весь хвост отображения, если элемент не больше страницы. Иначе округление
+    // ёмкости обратно в байты не восстановило бы размер отображения
+    static size_t GetMappedCount(size_t n, size_t mapped_bytes) noexcept {
+        return sizeof(T) <= PAGE_SIZE ? mapped_bytes / sizeof(T) : n;
+    }
+
+    static void AdviseHugePages([[maybe_unused]] void* ptr, [[maybe_unused]] size_t bytes) noexcept {
+#if defined(MADV_HUGEPAGE)
+        if (bytes >= HUGE_PAGE_SIZE) {
+            madvise(ptr, bytes, MADV_HUGEPAGE);
+        }
+#endif
+    }
+};
@@ -0,0 +1,480 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+// Двусторонняя очередь в кольцевом буфере RawMemory. Элементы занимают Size() ячеек, начиная
+// с head_, и при необходимости переходят через конец буфера в его начало, поэтому вставка и удаление
+// с обоих концов выполняются за амортизированное O(1) без сдвига остальных элементов.
+// При росте кольцо разворачивается в новый буфер не более чем двумя переносами
+template <typename T, typename Allocator = std::allocator<T>, typename GrowthPolicy = DoublingGrowth>
+class RingVector {
+    using AllocTraits = std::allocator_traits<Allocator>;
+
+    template <bool IsConst>
+    class BasicIterator {
+        using Container = std::conditional_t<IsConst, const RingVector, RingVector>;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<IsConst, const T*, T*>;
+        using reference = std::conditional_t<IsConst, const T&, T&>;
+
+        BasicIterator() = default;
+
+        BasicIterator(Container* container, size_t index) noexcept
+            : container_(container)
+            , index_(index) {
+        }
+
+        // Итератор по изменяемым элементам приводится к итератору по константным
+        operator BasicIterator<true>() const noexcept {
+            return BasicIterator<true>(container_, index_);
+        }
+
+        reference operator*() const noexcept {
+            return (*container_)[index_];
+        }
+        pointer operator->() const noexcept {
+            return &(*container_)[index_];
+        }
+        reference operator[](difference_type offset) const noexcept {
+            return (*container_)[index_ + offset];
+        }
+
+        BasicIterator& operator++() noexcept {
+            ++index_;
+            return *this;
+        }
+        BasicIterator operator++(int) noexcept {
+            BasicIterator old(*this);
+            ++index_;
+            return old;
+        }
+        BasicIterator& operator--() noexcept {
+            --index_;
+            return *this;
+        }
+        BasicIterator operator--(int) noexcept {
+            BasicIterator old(*this);
+            --index_;
+            return old;
+        }
+
+        BasicIterator& operator+=(difference_type offset) noexcept {
+            index_ += offset;
+            return *this;
+        }
+        BasicIterator& operator-=(difference_type offset) noexcept {
+            index_ -= offset;
+            return *this;
+        }
+        friend BasicIterator operator+(BasicIterator it, difference_type offset) noexcept {
+            return it += offset;
+        }
+        friend BasicIterator operator+(difference_type offset, BasicIterator it) noexcept {
+            return it += offset;
+        }
+        friend BasicIterator operator-(BasicIterator it, difference_type offset) noexcept {
+            return it -= offset;
+        }
+        friend difference_type operator-(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+        }
+
+        friend bool operator==(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ == rhs.index_;
+        }
+        friend bool operator!=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ != rhs.index_;
+        }
+        friend bool operator<(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ < rhs.index_;
+        }
+        friend bool operator>(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ > rhs.index_;
+        }
+        friend bool operator<=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ <= rhs.index_;
+        }
+        friend bool operator>=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ >= rhs.index_;
+        }
+
+    private:
+        Container* container_ = nullptr;
+        size_t index_ = 0;
+    };
+
+public:
+    using allocator_type = Allocator;
+    using iterator = BasicIterator<false>;
+    using const_iterator = BasicIterator<true>;
+
+    RingVector() = default;
+
+    explicit RingVector(const Allocator& alloc) noexcept
+        : data_(alloc) {
+    }
+
+    RingVector(const RingVector& other)
+        : data_(other.size_, AllocTraits::select_on_container_copy_construction(other.GetAllocator())) {
+        const size_t first_count = other.GetFirstCount();
+        std::uninitialized_copy_n(other.data_.GetAddress() + other.head_, first_count, data_.GetAddress());
+        VECTOR_TRY {
+            std::uninitialized_copy_n(other.data_.GetAddress(), other.size_ - first_count, data_.GetAddress() + first_count);
+        } VECTOR_CATCH_ALL {
+            std::destroy_n(data_.GetAddress(), first_count);
+            VECTOR_RETHROW;
+        }
+        size_ = other.size_;
+    }
+
+    RingVector(RingVector&& other) noexcept
+        : data_(std::move(other.data_))
+        , head_(std::exchange(other.head_, 0))
+        , size_(std::exchange(other.size_, 0)) {
+    }
+
+    // Если alloc не равен аллокатору other, элементы по одному перемещаются в память alloc
+    RingVector(RingVector&& other, const Allocator& alloc)
+        : data_(alloc) {
+        if (alloc == other.GetAllocator()) {
+            data_.Swap(other.data_);
+            head_ = std::exchange(other.head_, 0);
+            size_ = std::exchange(other.size_, 0);
+            return;
+        }
+        RawMemory<T, Allocator> new_data(other.size_, alloc);
+        T* from = other.data_.GetAddress();
+        const size_t first_count = other.GetFirstCount();
+        std::uninitialized_move_n(from + other.head_, first_count, new_data.GetAddress());
+        VECTOR_TRY {
+            std::uninitialized_move_n(from, other.size_ - first_count, new_data.GetAddress() + first_count);
+        } VECTOR_CATCH_ALL {
+            std::destroy_n(new_data.GetAddress(), first_count);
+            VECTOR_RETHROW;
+        }
+        data_.Swap(new_data);
+        size_ = other.size_;
+    }
+
+    RingVector& operator=(const RingVector& rhs) {
+        if (this != &rhs) {
+            RingVector rhs_copy(rhs);
+            Swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    RingVector& operator=(RingVector&& rhs) noexcept(AllocTraits::propagate_on_container_move_assignment::value
+                                                     || AllocTraits::is_always_equal::value) {
+        if (this == &rhs) {
+            return *this;
+        }
+        if constexpr (!AllocTraits::propagate_on_container_move_assignment::value
+                      && !AllocTraits::is_always_equal::value) {
+            if (GetAllocator() != rhs.GetAllocator()) {
+                // Буфер rhs нельзя забрать, поэтому элементы перемещаются в память текущего аллокатора
+                RingVector rhs_moved(std::move(rhs), GetAllocator());
+                Swap(rhs_moved);
+                return *this;
+            }
+        }
+        Clear();
+        data_ = std::move(rhs.data_);
+        head_ = std::exchange(rhs.head_, 0);
+        size_ = std::exchange(rhs.size_, 0);
+        return *this;
+    }
+
+    ~RingVector() {
+        Clear();
+    }
+
+    void Swap(RingVector& other) noexcept {
+        data_.Swap(other.data_);
+        std::swap(head_, other.head_);
+        std::swap(size_, other.size_);
+    }
+
+    iterator begin() noexcept {
+        return {this, 0};
+    }
+    iterator end() noexcept {
+        return {this, size_};
+    }
+    const_iterator begin() const noexcept {
+        return {this, 0};
+    }
+    const_iterator end() const noexcept {
+        return {this, size_};
+    }
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return data_.Capacity();
+    }
+
+    size_t MaxSize() const noexcept {
+        return AllocTraits::max_size(GetAllocator());
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return data_.GetAddress()[Wrap(head_ + index)];
+    }
+
+    T& operator[](size_t index) noexcept {
+        return const_cast<T&>(std::as_const(*this)[index]);
+    }
+
+    const T& Front() const noexcept {
+        return (*this)[0];
+    }
+
+    T& Front() noexcept {
+        return (*this)[0];
+    }
+
+    const T& Back() const noexcept {
+        return (*this)[size_ - 1];
+    }
+
+    T& Back() noexcept {
+        return (*this)[size_ - 1];
+    }
+
+    void Reserve(size_t new_capacity) {
+        if (new_capacity <= Capacity()) {
+            return;
+        }
+        RawMemory<T, Allocator> new_data(new_capacity, GetAllocator());
+        Unwrap(new_data);
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        if (size_ == Capacity()) {
+            RawMemory<T, Allocator> new_data(GetNextCapacity(), GetAllocator());
+            // Аргументы могут ссылаться на элементы, поэтому новый элемент создаётся до переноса
+            T* result = new (new_data.GetAddress() + size_) T(std::forward<Args>(args)...);
+            UnwrapOrDestroy(new_data, result);
+            ++size_;
+            return *result;
+        }
+        T* result = new (data_.GetAddress() + Wrap(head_ + size_)) T(std::forward<Args>(args)...);
+        ++size_;
+        return *result;
+    }
+
+    template <typename... Args>
+    T& EmplaceFront(Args&&... args) {
+        if (size_ == Capacity()) {
+            RawMemory<T, Allocator> new_data(GetNextCapacity(), GetAllocator());
+            const size_t new_head = new_data.Capacity() - 1;
+            T* result = new (new_data.GetAddress() + new_head) T(std::forward<Args>(args)...);
+            UnwrapOrDestroy(new_data, result);
+            head_ = new_head;
+            ++size_;
+            return *result;
+        }
+        const size_t new_head = head_ == 0 ? Capacity() - 1 : head_ - 1;
+        T* result = new (data_.GetAddress() + new_head) T(std::forward<Args>(args)...);
+        head_ = new_head;
+        ++size_;
+        return *result;
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    void PushFront(const T& value) {
+        EmplaceFront(value);
+    }
+
+    void PushFront(T&& value) {
+        EmplaceFront(std::move(value));
+    }
+
+    void PopBack() noexcept {
+        assert(size_ != 0);
+        --size_;
+        data_.GetAddress()[Wrap(head_ + size_)].~T();
+        if (size_ == 0) {
+            head_ = 0;
+        }
+    }
+
+    void PopFront() noexcept {
+        assert(size_ != 0);
+        data_.GetAddress()[head_].~T();
+        head_ = Wrap(head_ + 1);
+        --size_;
+        if (size_ == 0) {
+            head_ = 0;
+        }
+    }
+
+    void Clear() noexcept {
+        const size_t first_count = GetFirstCount();
+        std::destroy_n(data_.GetAddress() + head_, first_count);
+        std::destroy_n(data_.GetAddress(), size_ - first_count);
+        head_ = 0;
+        size_ = 0;
+    }
+
+    // Делает элементы непрерывными и возвращает адрес первого из них. Если кольцо переходит через
+    // конец буфера, элементы, перенос которых не выбрасывает исключений, переставляются на месте
+    // без выделения памяти. Остальные разворачиваются в новый буфер той же вместимости, чтобы
+    // при исключении кольцо осталось прежним
+    T* Linearize() {
+        if (GetFirstCount() != size_) {
+            if constexpr (IS_NOTHROW_ROTATABLE) {
+                RotateToFront();
+            } else {
+                RawMemory<T, Allocator> new_data(Capacity(), GetAllocator());
+                Unwrap(new_data);
+            }
+        }
+        return data_.GetAddress() + head_;
+    }
+
+    // Проверяет, что элементы занимают непрерывный участок буфера
+    bool IsLinear() const noexcept {
+        return GetFirstCount() == size_;
+    }
+
+    const Allocator& GetAllocator() const noexcept {
+        return data_.GetAllocator();
+    }
+
+private:
+    size_t Wrap(size_t index) const noexcept {
+        return index < Capacity() ? index : index - Capacity();
+    }
+
+    // Число элементов от head_ до конца буфера
+    size_t GetFirstCount() const noexcept {
+        return std::min(size_, Capacity() - head_);
+    }
+
+    size_t GetNextCapacity() const {
+        if (size_ == MaxSize()) {
+            VECTOR_THROW(std::length_error("RingVector is too long"));
+        }
+        return GrowthPolicy::template NextCapacity<T>(Capacity(), size_ + 1);
+    }
+
+    static constexpr bool IS_NOTHROW_ROTATABLE = IsTriviallyRelocatable<T>::value
+        || (std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>);
+
+    // Переставляет элементы разорванного кольца так, чтобы оно начиналось с начала буфера
+    void RotateToFront() noexcept {
+        T* buffer = data_.GetAddress();
+        const size_t capacity = Capacity();
+        if constexpr (IsTriviallyRelocatable<T>::value) {
+            // Буфер [вторая часть][свободно][первая часть] циклически сдвигается побайтово
+            unsigned char* bytes = reinterpret_cast<unsigned char*>(buffer);
+            std::rotate(bytes, bytes + head_ * sizeof(T), bytes + capacity * sizeof(T));
+        } else {
+            const size_t first_count = capacity - head_;
+            const size_t second_count = size_ - first_count;
+            const size_t gap = capacity - size_;
+            // Первая часть сдвигается в свободные ячейки сразу за второй: первые gap ячеек назначения
+            // не инициализированы, а последние gap исходных ячеек после сдвига освобождаются
+            if (gap != 0) {
+                const size_t constructed = std::min(gap, first_count);
+                T* from = buffer + head_;
+                T* to = buffer + second_count;
+                std::uninitialized_move_n(from, constructed, to);
+                std::move(from + constructed, buffer + capacity, to + constructed);
+                std::destroy_n(buffer + capacity - constructed, constructed);
+            }
+            std::rotate(buffer, buffer + second_count, buffer + size_);
+        }
+        head_ = 0;
+    }
+
+    // Переносит элементы в начало new_data двумя переносами: от head_ до конца буфера
+    // и от начала буфера. Если перенос выбросил исключение, кольцо сохраняет размер и буфер,
+    // а значения меняются только у некопируемых элементов с выбрасывающим перемещением
+    void Unwrap(RawMemory<T, Allocator>& new_data) {
+        T* buffer = data_.GetAddress();
+        T* to = new_data.GetAddress();
+        const size_t first_count = GetFirstCount();
+        const size_t second_count = size_ - first_count;
+        if constexpr (IsTriviallyRelocatable<T>::value) {
+            if (first_count != 0) {
+                std::memcpy(static_cast<void*>(to), static_cast<const void*>(buffer + head_), first_count * sizeof(T));
+            }
+            if (second_count != 0) {
+                std::memcpy(static_cast<void*>(to + first_count), static_cast<const void*>(buffer), second_count * sizeof(T));
+            }
+        } else if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+            std::uninitialized_move_n(buffer + head_, first_count, to);
+            if constexpr (std::is_nothrow_move_constructible_v<T>) {
+                std::uninitialized_move_n(buffer, second_count, to + first_count);
+            } else {
+                // Некопируемые элементы с выбрасывающим перемещением: первая часть остаётся перемещённой
+                VECTOR_TRY {
+                    std::uninitialized_move_n(buffer, second_count, to + first_count);
+                } VECTOR_CATCH_ALL {
+                    std::destroy_n(to, first_count);
+                    VECTOR_RETHROW;
+                }
+            }
+            std::destroy_n(buffer + head_, first_count);
+            std::destroy_n(buffer, second_count);
+        } else {
+            std::uninitialized_copy_n(buffer + head_, first_count, to);
+            VECTOR_TRY {
+                std::uninitialized_copy_n(buffer, second_count, to + first_count);
+            } VECTOR_CATCH_ALL {
+                std::destroy_n(to, first_count);
+                VECTOR_RETHROW;
+            }
+            std::destroy_n(buffer + head_, first_count);
+            std::destroy_n(buffer, second_count);
+        }
+        data_.Swap(new_data);
+        head_ = 0;
+    }
+
+    // Как Unwrap, но при исключении уничтожает уже созданный в new_data элемент
+    void UnwrapOrDestroy(RawMemory<T, Allocator>& new_data, T* element) {
+        VECTOR_TRY {
+            Unwrap(new_data);
+        } VECTOR_CATCH_ALL {
+            element->~T();
+            VECTOR_RETHROW;
+        }
+    }
+
+    RawMemory<T, Allocator> data_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+};
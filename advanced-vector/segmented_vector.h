@@ -0,0 +1,340 @@
+#pragma once
+#include "vector.h"
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+// Вектор, хранящий элементы в блоках RawMemory по ChunkSize элементов. При росте добавляется
+// новый блок, а уже созданные элементы не перемещаются, поэтому указатели и ссылки на них
+// остаются действительными до удаления самих элементов. Индекс блоков хранится в обычном Vector
+template <typename T, size_t ChunkSize = std::max<size_t>(16, 4096 / sizeof(T)), typename Allocator = std::allocator<T>>
+class SegmentedVector {
+    static_assert(ChunkSize != 0, "Chunk size must be positive");
+
+    using AllocTraits = std::allocator_traits<Allocator>;
+    using Chunk = RawMemory<T, Allocator>;
+
+    template <bool IsConst>
+    class BasicIterator {
+        using Container = std::conditional_t<IsConst, const SegmentedVector, SegmentedVector>;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<IsConst, const T*, T*>;
+        using reference = std::conditional_t<IsConst, const T&, T&>;
+
+        BasicIterator() = default;
+
+        BasicIterator(Container* container, size_t index) noexcept
+            : container_(container)
+            , index_(index) {
+        }
+
+        // Итератор по изменяемым элементам приводится к итератору по константным
+        operator BasicIterator<true>() const noexcept {
+            return BasicIterator<true>(container_, index_);
+        }
+
+        reference operator*() const noexcept {
+            return (*container_)[index_];
+        }
+        pointer operator->() const noexcept {
+            return &(*container_)[index_];
+        }
+        reference operator[](difference_type offset) const noexcept {
+            return (*container_)[index_ + offset];
+        }
+
+        BasicIterator& operator++() noexcept {
+            ++index_;
+            return *this;
+        }
+        BasicIterator operator++(int) noexcept {
+            BasicIterator old(*this);
+            ++index_;
+            return old;
+        }
+        BasicIterator& operator--() noexcept {
+            --index_;
+            return *this;
+        }
+        BasicIterator operator--(int) noexcept {
+            BasicIterator old(*this);
+            --index_;
+            return old;
+        }
+
+        BasicIterator& operator+=(difference_type offset) noexcept {
+            index_ += offset;
+            return *this;
+        }
+        BasicIterator& operator-=(difference_type offset) noexcept {
+            index_ -= offset;
+            return *this;
+        }
+        friend BasicIterator operator+(BasicIterator it, difference_type offset) noexcept {
+            return it += offset;
+        }
+        friend BasicIterator operator+(difference_type offset, BasicIterator it) noexcept {
+            return it += offset;
+        }
+        friend BasicIterator operator-(BasicIterator it, difference_type offset) noexcept {
+            return it -= offset;
+        }
+        friend difference_type operator-(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+        }
+
+        friend bool operator==(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ == rhs.index_;
+        }
+        friend bool operator!=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ != rhs.index_;
+        }
+        friend bool operator<(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ < rhs.index_;
+        }
+        friend bool operator>(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ > rhs.index_;
+        }
+        friend bool operator<=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ <= rhs.index_;
+        }
+        friend bool operator>=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ >= rhs.index_;
+        }
+
+    private:
+        Container* container_ = nullptr;
+        size_t index_ = 0;
+    };
+
+public:
+    using allocator_type = Allocator;
+    using iterator = BasicIterator<false>;
+    using const_iterator = BasicIterator<true>;
+
+    static constexpr size_t CHUNK_SIZE = ChunkSize;
+
+    SegmentedVector() = default;
+
+    explicit SegmentedVector(const Allocator& alloc) noexcept
+        : alloc_(alloc) {
+    }
+
+    SegmentedVector(const SegmentedVector& other)
+        : SegmentedVector(other, AllocTraits::select_on_container_copy_construction(other.alloc_)) {
+    }
+
+    SegmentedVector(const SegmentedVector& other, const Allocator& alloc)
+        : alloc_(alloc) {
+        Reserve(other.size_);
+        VECTOR_TRY {
+            for (const T& value : other) {
+                EmplaceBack(value);
+            }
+        } VECTOR_CATCH_ALL {
+            Clear();
+            VECTOR_RETHROW;
+        }
+    }
+
+    SegmentedVector(SegmentedVector&& other) noexcept
+        : alloc_(other.alloc_)
+        , chunks_(std::move(other.chunks_))
+        , size_(std::exchange(other.size_, 0)) {
+    }
+
+    // Если блоки other выделены другим аллокатором, элементы перемещаются по одному
+    SegmentedVector(SegmentedVector&& other, const Allocator& alloc)
+        : alloc_(alloc) {
+        if (alloc_ == other.alloc_) {
+            chunks_ = std::move(other.chunks_);
+            size_ = std::exchange(other.size_, 0);
+            return;
+        }
+        Reserve(other.size_);
+        VECTOR_TRY {
+            for (T& value : other) {
+                EmplaceBack(std::move(value));
+            }
+        } VECTOR_CATCH_ALL {
+            Clear();
+            VECTOR_RETHROW;
+        }
+    }
+
+    // Аллокатор переходит к *this, только если того требует propagate_on_container_copy_assignment
+    SegmentedVector& operator=(const SegmentedVector& rhs) {
+        if (this != &rhs) {
+            constexpr bool PROPAGATE = AllocTraits::propagate_on_container_copy_assignment::value;
+            SegmentedVector rhs_copy(rhs, PROPAGATE ? rhs.alloc_ : alloc_);
+            TakeChunks(rhs_copy);
+            if constexpr (PROPAGATE) {
+                alloc_ = rhs.alloc_;
+            }
+        }
+        return *this;
+    }
+
+    // Аллокатор переходит к *this, только если того требует propagate_on_container_move_assignment.
+    // Блоки rhs с другим аллокатором забрать нельзя, поэтому его элементы перемещаются по одному
+    SegmentedVector& operator=(SegmentedVector&& rhs) noexcept(AllocTraits::propagate_on_container_move_assignment::value
+                                                               || AllocTraits::is_always_equal::value) {
+        if (this == &rhs) {
+            return *this;
+        }
+        if constexpr (!AllocTraits::propagate_on_container_move_assignment::value
+                      && !AllocTraits::is_always_equal::value) {
+            if (alloc_ != rhs.alloc_) {
+                SegmentedVector rhs_moved(std::move(rhs), alloc_);
+                TakeChunks(rhs_moved);
+                return *this;
+            }
+        }
+        TakeChunks(rhs);
+        if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+            alloc_ = rhs.alloc_;
+        }
+        return *this;
+    }
+
+    ~SegmentedVector() {
+        Clear();
+    }
+
+    // Аллокаторы обмениваются, только если того требует propagate_on_container_swap,
+    // иначе они обязаны быть равны
+    void Swap(SegmentedVector& other) noexcept {
+        if constexpr (AllocTraits::propagate_on_container_swap::value) {
+            std::swap(alloc_, other.alloc_);
+        } else {
+            assert(alloc_ == other.alloc_);
+        }
+        chunks_.Swap(other.chunks_);
+        std::swap(size_, other.size_);
+    }
+
+    iterator begin() noexcept {
+        return {this, 0};
+    }
+    iterator end() noexcept {
+        return {this, size_};
+    }
+    const_iterator begin() const noexcept {
+        return {this, 0};
+    }
+    const_iterator end() const noexcept {
+        return {this, size_};
+    }
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return chunks_.Size() * ChunkSize;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return chunks_[index / ChunkSize].GetAddress()[index % ChunkSize];
+    }
+
+    T& operator[](size_t index) noexcept {
+        return const_cast<T&>(std::as_const(*this)[index]);
+    }
+
+    // Выделяет блоки так, чтобы в них помещалось new_capacity элементов
+    void Reserve(size_t new_capacity) {
+        const size_t num_chunks = (new_capacity + ChunkSize - 1) / ChunkSize;
+        chunks_.Reserve(num_chunks);
+        while (chunks_.Size() < num_chunks) {
+            chunks_.EmplaceBack(ChunkSize, alloc_);
+        }
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        // Аргументы могут ссылаться на элементы вектора, но новый блок их не перемещает
+        if (size_ == Capacity()) {
+            chunks_.EmplaceBack(ChunkSize, alloc_);
+        }
+        T* slot = new (GetSlot(size_)) T(std::forward<Args>(args)...);
+        ++size_;
+        return *slot;
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    // Блоки не освобождаются, поэтому чередование PushBack и PopBack на границе блока
+    // не приводит к повторным выделениям памяти
+    void PopBack() noexcept {
+        assert(size_ != 0);
+        --size_;
+        GetSlot(size_)->~T();
+    }
+
+    void Resize(size_t new_size) {
+        while (size_ > new_size) {
+            PopBack();
+        }
+        Reserve(new_size);
+        while (size_ < new_size) {
+            EmplaceBack();
+        }
+    }
+
+    void Clear() noexcept {
+        while (size_ != 0) {
+            PopBack();
+        }
+    }
+
+    // Освобождает блоки, в которых не осталось элементов
+    void ShrinkToFit() noexcept {
+        const size_t num_chunks = (size_ + ChunkSize - 1) / ChunkSize;
+        while (chunks_.Size() > num_chunks) {
+            chunks_.PopBack();
+        }
+    }
+
+    const Allocator& GetAllocator() const noexcept {
+        return alloc_;
+    }
+
+private:
+    // Уничтожает элементы и забирает блоки other, которые освобождает своим аллокатором каждый блок
+    void TakeChunks(SegmentedVector& other) noexcept {
+        Clear();
+        // Старые блоки освобождает временный индекс
+        Vector<Chunk>(std::move(other.chunks_)).Swap(chunks_);
+        size_ = std::exchange(other.size_, 0);
+    }
+
+    T* GetSlot(size_t index) noexcept {
+        return chunks_[index / ChunkSize].GetAddress() + index % ChunkSize;
+    }
+
+    [[no_unique_address]] Allocator alloc_;
+    Vector<Chunk> chunks_;
+    size_t size_ = 0;
+};
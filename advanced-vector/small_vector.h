@@ -0,0 +1,114 @@
+#pragma once
+#include "vector.h"
+
+// Сырая память со встроенным буфером на N элементов. Пока вместимости встроенного буфера достаточно,
+// память у аллокатора не запрашивается, а при реаллокации вектор передаёт буфер в куче через Swap
+template <typename T, size_t N, typename Allocator = std::allocator<T>>
+class SmallRawMemory {
+    static_assert(N > 0, "Inline capacity must be positive");
+
+public:
+    using allocator_type = Allocator;
+
+    static constexpr size_t INLINE_CAPACITY = N;
+
+    static constexpr bool CAN_EXPAND = RawMemory<T, Allocator>::CAN_EXPAND;
+    static constexpr bool CAN_REALLOCATE = RawMemory<T, Allocator>::CAN_REALLOCATE;
+
+    SmallRawMemory() = default;
+
+    explicit SmallRawMemory(const Allocator& alloc) noexcept
+        : heap_(alloc) {
+    }
+
+    explicit SmallRawMemory(size_t capacity, const Allocator& alloc = Allocator())
+        : heap_(capacity > N ? capacity : 0, alloc) {
+    }
+
+    SmallRawMemory(const SmallRawMemory&) = delete;
+    SmallRawMemory& operator=(const SmallRawMemory& rhs) = delete;
+
+    // Перемещается только буфер в куче. Содержимое встроенного буфера переносит вектор,
+    // которому известно число живых элементов
+    SmallRawMemory(SmallRawMemory&& other) noexcept
+        : heap_(std::move(other.heap_)) {
+    }
+
+    SmallRawMemory& operator=(SmallRawMemory&& rhs) noexcept {
+        heap_ = std::move(rhs.heap_);
+        return *this;
+    }
+
+    T* operator+(size_t offset) noexcept {
+        // Разрешается получать адрес ячейки памяти, следующей за последним элементом массива
+        assert(offset <= Capacity());
+        return GetAddress() + offset;
+    }
+
+    const T* operator+(size_t offset) const noexcept {
+        return const_cast<SmallRawMemory&>(*this) + offset;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<SmallRawMemory&>(*this)[index];
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < Capacity());
+        return GetAddress()[index];
+    }
+
+    // Обмениваются только буферы в куче, поэтому во встроенных буферах к моменту вызова
+    // не должно быть живых элементов
+    void Swap(SmallRawMemory& other) noexcept {
+        heap_.Swap(other.heap_);
+    }
+
+    // Заменяет текущую память буфером buffer. Элементы во встроенном буфере к этому моменту
+    // должны быть перенесены или уничтожены
+    void Swap(RawMemory<T, Allocator>& buffer) noexcept {
+        heap_.Swap(buffer);
+    }
+
+    // Встроенный буфер нельзя ни расширить, ни перенести средствами аллокатора
+    bool TryExpand(size_t new_capacity) noexcept {
+        return !IsInline() && heap_.TryExpand(new_capacity);
+    }
+
+    bool TryReallocate(size_t new_capacity) {
+        return !IsInline() && heap_.TryReallocate(new_capacity);
+    }
+
+    void ResetAllocator(const Allocator& alloc) noexcept {
+        heap_.ResetAllocator(alloc);
+    }
+
+    const T* GetAddress() const noexcept {
+        return const_cast<SmallRawMemory&>(*this).GetAddress();
+    }
+
+    T* GetAddress() noexcept {
+        return IsInline() ? std::launder(reinterpret_cast<T*>(inline_buffer_)) : heap_.GetAddress();
+    }
+
+    size_t Capacity() const noexcept {
+        return IsInline() ? N : heap_.Capacity();
+    }
+
+    bool IsInline() const noexcept {
+        return heap_.Capacity() == 0;
+    }
+
+    const Allocator& GetAllocator() const noexcept {
+        return heap_.GetAllocator();
+    }
+
+private:
+    RawMemory<T, Allocator> heap_;
+    alignas(T) unsigned char inline_buffer_[N * sizeof(T)];
+};
+
+// Вектор, хранящий до N элементов внутри объекта и использующий кучу только при переполнении
+template <typename T, size_t N, typename Allocator = std::allocator<T>, typename GrowthPolicy = DoublingGrowth,
+          typename Stats = NoStats>
+using SmallVector = BasicVector<T, SmallRawMemory<T, N, Allocator>, GrowthPolicy, Stats>;
@@ -0,0 +1,379 @@
+#pragma once
+#include "vector.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Непрерывный участок столбца SoaVector. Действителен до ближайшей реаллокации вектора
+template <typename T>
+class ColumnSpan {
+public:
+    ColumnSpan() = default;
+
+    ColumnSpan(T* data, size_t size) noexcept
+        : data_(data)
+        , size_(size) {
+    }
+
+    T* begin() const noexcept {
+        return data_;
+    }
+    T* end() const noexcept {
+        return data_ + size_;
+    }
+
+    T* Data() const noexcept {
+        return data_;
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    T& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return data_[index];
+    }
+
+private:
+    T* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+// Вектор строк из полей Ts..., хранящий каждое поле в отдельном столбце RawMemory. Все столбцы
+// имеют общие размер и вместимость и реаллоцируются вместе, а операции дают те же гарантии
+// безопасности исключений, что и у Vector. Строка доступна через прокси std::tuple<Ts&...>,
+// а столбец целиком — через Column<I>(), что позволяет обрабатывать его векторизованными циклами
+template <typename GrowthPolicy, typename... Ts>
+class BasicSoaVector {
+    static_assert(sizeof...(Ts) > 0, "SoaVector must have at least one column");
+
+    using Columns = std::tuple<RawMemory<Ts>...>;
+    using Indices = std::index_sequence_for<Ts...>;
+
+public:
+    using value_type = std::tuple<Ts...>;
+    using reference = std::tuple<Ts&...>;
+    using const_reference = std::tuple<const Ts&...>;
+
+    template <size_t I>
+    using ColumnType = std::tuple_element_t<I, value_type>;
+
+    static constexpr size_t NUM_COLUMNS = sizeof...(Ts);
+
+    BasicSoaVector() = default;
+
+    explicit BasicSoaVector(size_t size)
+        : columns_(RawMemory<Ts>(size)...)
+        , capacity_(size) {
+        ForEachColumn(
+            [this, size](auto column) {
+                std::uninitialized_value_construct_n(GetColumn<column>(columns_), size);
+            },
+            [this, size](auto column) noexcept {
+                std::destroy_n(GetColumn<column>(columns_), size);
+            });
+        size_ = size;
+    }
+
+    BasicSoaVector(const BasicSoaVector& other)
+        : columns_(RawMemory<Ts>(other.size_)...)
+        , capacity_(other.size_) {
+        ForEachColumn(
+            [this, &other](auto column) {
+                std::uninitialized_copy_n(GetColumn<column>(other.columns_), other.size_, GetColumn<column>(columns_));
+            },
+            [this, &other](auto column) noexcept {
+                std::destroy_n(GetColumn<column>(columns_), other.size_);
+            });
+        size_ = other.size_;
+    }
+
+    BasicSoaVector(BasicSoaVector&& other) noexcept
+        : columns_(std::move(other.columns_))
+        , size_(std::exchange(other.size_, 0))
+        , capacity_(std::exchange(other.capacity_, 0)) {
+    }
+
+    BasicSoaVector& operator=(const BasicSoaVector& rhs) {
+        if (this != &rhs) {
+            BasicSoaVector rhs_copy(rhs);
+            Swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    BasicSoaVector& operator=(BasicSoaVector&& rhs) noexcept {
+        if (this != &rhs) {
+            Clear();
+            SwapColumns(rhs.columns_, Indices{});
+            size_ = std::exchange(rhs.size_, 0);
+            std::swap(capacity_, rhs.capacity_);
+        }
+        return *this;
+    }
+
+    ~BasicSoaVector() {
+        Clear();
+    }
+
+    void Swap(BasicSoaVector& other) noexcept {
+        SwapColumns(other.columns_, Indices{});
+        std::swap(size_, other.size_);
+        std::swap(capacity_, other.capacity_);
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return capacity_;
+    }
+
+    reference operator[](size_t index) noexcept {
+        assert(index < size_);
+        return MakeRow(index, Indices{});
+    }
+
+    const_reference operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return MakeRow(index, Indices{});
+    }
+
+    template <size_t I>
+    ColumnType<I>& Get(size_t index) noexcept {
+        assert(index < size_);
+        return GetColumn<I>(columns_)[index];
+    }
+
+    template <size_t I>
+    const ColumnType<I>& Get(size_t index) const noexcept {
+        assert(index < size_);
+        return GetColumn<I>(columns_)[index];
+    }
+
+    template <size_t I>
+    ColumnSpan<ColumnType<I>> Column() noexcept {
+        return {GetColumn<I>(columns_), size_};
+    }
+
+    template <size_t I>
+    ColumnSpan<const ColumnType<I>> Column() const noexcept {
+        return {GetColumn<I>(columns_), size_};
+    }
+
+    void Reserve(size_t new_capacity) {
+        if (new_capacity <= capacity_) {
+            return;
+        }
+        Columns new_columns{RawMemory<Ts>(new_capacity)...};
+        RelocateColumns(new_columns);
+        SwapColumns(new_columns, Indices{});
+        capacity_ = new_capacity;
+    }
+
+    void Resize(size_t new_size) {
+        if (new_size <= size_) {
+            DestroyRows(new_size);
+            return;
+        }
+        Reserve(new_size);
+        ForEachColumn(
+            [this, new_size](auto column) {
+                std::uninitialized_value_construct_n(GetColumn<column>(columns_) + size_, new_size - size_);
+            },
+            [this, new_size](auto column) noexcept {
+                std::destroy_n(GetColumn<column>(columns_) + size_, new_size - size_);
+            });
+        size_ = new_size;
+    }
+
+    // Создаёт строку, передавая конструктору каждого поля соответствующий аргумент
+    template <typename... Args>
+    reference EmplaceBack(Args&&... args) {
+        static_assert(sizeof...(Args) == sizeof...(Ts), "EmplaceBack expects one argument per column");
+        auto values = std::forward_as_tuple(std::forward<Args>(args)...);
+        if (size_ == capacity_) {
+            if (size_ == MaxSize()) {
+                VECTOR_THROW(std::length_error("SoaVector is too long"));
+            }
+            const size_t new_capacity = GrowthPolicy::template NextCapacity<value_type>(capacity_, size_ + 1);
+            Columns new_columns{RawMemory<Ts>(new_capacity)...};
+            // Аргументы могут ссылаться на элементы вектора, поэтому строка создаётся до переноса
+            ConstructRow(new_columns, std::move(values));
+            VECTOR_TRY {
+                RelocateColumns(new_columns);
+            } VECTOR_CATCH_ALL {
+                DestroyRow(new_columns, size_);
+                VECTOR_RETHROW;
+            }
+            SwapColumns(new_columns, Indices{});
+            capacity_ = new_capacity;
+        } else {
+            ConstructRow(columns_, std::move(values));
+        }
+        ++size_;
+        return (*this)[size_ - 1];
+    }
+
+    void PushBack(const value_type& row) {
+        std::apply([this](const Ts&... values) {
+            EmplaceBack(values...);
+        }, row);
+    }
+
+    void PushBack(value_type&& row) {
+        std::apply([this](Ts&... values) {
+            EmplaceBack(std::move(values)...);
+        }, row);
+    }
+
+    void PopBack() noexcept {
+        assert(size_ != 0);
+        --size_;
+        DestroyRow(columns_, size_);
+    }
+
+    void Clear() noexcept {
+        DestroyRows(0);
+    }
+
+    size_t MaxSize() const noexcept {
+        return std::min({std::allocator_traits<std::allocator<Ts>>::max_size(std::allocator<Ts>())...});
+    }
+
+private:
+    template <size_t I>
+    static ColumnType<I>* GetColumn(Columns& columns) noexcept {
+        return std::get<I>(columns).GetAddress();
+    }
+
+    template <size_t I>
+    static const ColumnType<I>* GetColumn(const Columns& columns) noexcept {
+        return std::get<I>(columns).GetAddress();
+    }
+
+    template <size_t... I>
+    reference MakeRow(size_t index, std::index_sequence<I...>) noexcept {
+        return reference(GetColumn<I>(columns_)[index]...);
+    }
+
+    template <size_t... I>
+    const_reference MakeRow(size_t index, std::index_sequence<I...>) const noexcept {
+        return const_reference(GetColumn<I>(columns_)[index]...);
+    }
+
+    template <size_t... I>
+    void SwapColumns(Columns& other, std::index_sequence<I...>) noexcept {
+        (std::get<I>(columns_).Swap(std::get<I>(other)), ...);
+    }
+
+    // Применяет op к столбцам по порядку, передавая номер столбца как std::integral_constant.
+    // Если op выбрасывает исключение, к уже обработанным столбцам применяется undo
+    template <typename Op, typename Undo>
+    static void ForEachColumn(Op op, Undo undo) {
+        ForEachColumn(op, undo, Indices{});
+    }
+
+    template <typename Op, typename Undo, size_t... I>
+    static void ForEachColumn(Op& op, Undo& undo, std::index_sequence<I...>) {
+        size_t done = 0;
+        VECTOR_TRY {
+            ((op(std::integral_constant<size_t, I>{}), ++done), ...);
+        } VECTOR_CATCH_ALL {
+            ((I < done ? undo(std::integral_constant<size_t, I>{}) : void()), ...);
+            VECTOR_RETHROW;
+        }
+    }
+
+    template <typename Values>
+    void ConstructRow(Columns& columns, Values&& values) {
+        ForEachColumn(
+            [this, &columns, &values](auto column) {
+                using T = ColumnType<column>;
+                new (GetColumn<column>(columns) + size_) T(std::get<column>(std::move(values)));
+            },
+            [this, &columns](auto column) noexcept {
+                using T = ColumnType<column>;
+                GetColumn<column>(columns)[size_].~T();
+            });
+    }
+
+    static void DestroyRow(Columns& columns, size_t index) noexcept {
+        ForEachColumn(
+            [&columns, index](auto column) noexcept {
+                using T = ColumnType<column>;
+                GetColumn<column>(columns)[index].~T();
+            },
+            [](auto) noexcept {
+            });
+    }
+
+    void DestroyRows(size_t new_size) noexcept {
+        ForEachColumn(
+            [this, new_size](auto column) noexcept {
+                std::destroy_n(GetColumn<column>(columns_) + new_size, size_ - new_size);
+            },
+            [](auto) noexcept {
+            });
+        size_ = new_size;
+    }
+
+    // Перенос столбца не выбрасывает исключений, если тип тривиально перемещаем или перемещается без исключений
+    template <typename T>
+    static constexpr bool IS_NOTHROW_RELOCATABLE = IsTriviallyRelocatable<T>::value
+        || std::is_nothrow_move_constructible_v<T>;
+
+    // Переносит элементы в new_columns. Сначала копируются столбцы, перемещение которых может
+    // выбросить исключение: при ошибке копии уничтожаются, а исходные столбцы остаются нетронутыми.
+    // Некопируемые столбцы таких типов перемещаются, и при ошибке исходные элементы остаются
+    // в перемещённом состоянии. Затем без исключений переносятся остальные столбцы
+    void RelocateColumns(Columns& new_columns) {
+        ForEachColumn(
+            [this, &new_columns](auto column) {
+                using T = ColumnType<column>;
+                if constexpr (!IS_NOTHROW_RELOCATABLE<T> && std::is_copy_constructible_v<T>) {
+                    std::uninitialized_copy_n(GetColumn<column>(columns_), size_, GetColumn<column>(new_columns));
+                } else if constexpr (!IS_NOTHROW_RELOCATABLE<T>) {
+                    std::uninitialized_move_n(GetColumn<column>(columns_), size_, GetColumn<column>(new_columns));
+                }
+            },
+            [this, &new_columns](auto column) noexcept {
+                using T = ColumnType<column>;
+                if constexpr (!IS_NOTHROW_RELOCATABLE<T>) {
+                    std::destroy_n(GetColumn<column>(new_columns), size_);
+                }
+            });
+        ForEachColumn(
+            [this, &new_columns](auto column) noexcept {
+                using T = ColumnType<column>;
+                T* from = GetColumn<column>(columns_);
+                T* to = GetColumn<column>(new_columns);
+                if constexpr (IsTriviallyRelocatable<T>::value) {
+                    if (size_ != 0) {
+                        std::memcpy(static_cast<void*>(to), static_cast<const void*>(from), size_ * sizeof(T));
+                    }
+                } else if constexpr (IS_NOTHROW_RELOCATABLE<T>) {
+                    std::uninitialized_move_n(from, size_, to);
+                    std::destroy_n(from, size_);
+                } else {
+                    std::destroy_n(from, size_);
+                }
+            },
+            [](auto) noexcept {
+            });
+    }
+
+    Columns columns_;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+};
+
+template <typename... Ts>
+using SoaVector = BasicSoaVector<DoublingGrowth, Ts...>;
@@ -0,0 +1,378 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace detail {
+
+// Хранилище StaticVector. Для тривиальных типов это обычный массив, поэтому вектор остаётся
+// тривиально копируемым и уничтожаемым и может использоваться в константных выражениях.
+// Во время выполнения массив не инициализируется, а при вычислении на этапе компиляции, где
+// неинициализированные значения недопустимы, заполняется нулями. До C++20 constexpr-конструктор
+// обязан инициализировать все члены, поэтому там массив заполняется нулями всегда
+template <typename T, size_t N, bool = std::is_trivial_v<T>>
+class StaticStorage {
+protected:
+#if defined(__cpp_lib_is_constant_evaluated)
+    constexpr StaticStorage() noexcept {
+        if (std::is_constant_evaluated()) {
+            for (T& element : elements_) {
+                element = T();
+            }
+        }
+    }
+#endif
+
+    constexpr T* GetSlots() noexcept {
+        return elements_;
+    }
+    constexpr const T* GetSlots() const noexcept {
+        return elements_;
+    }
+
+#if defined(__cpp_lib_is_constant_evaluated)
+    T elements_[N == 0 ? 1 : N];
+#else
+    T elements_[N == 0 ? 1 : N] = {};
+#endif
+    size_t size_ = 0;
+};
+
+// Для остальных типов элементы создаются размещающим new в выровненном буфере
+template <typename T, size_t N>
+class StaticStorage<T, N, false> {
+protected:
+    StaticStorage() = default;
+
+    StaticStorage(const StaticStorage& other) {
+        std::uninitialized_copy_n(other.GetSlots(), other.size_, GetSlots());
+        size_ = other.size_;
+    }
+
+    StaticStorage(StaticStorage&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        std::uninitialized_move_n(other.GetSlots(), other.size_, GetSlots());
+        size_ = other.size_;
+    }
+
+    StaticStorage& operator=(const StaticStorage& rhs) {
+        if (this != &rhs) {
+            Assign(rhs.GetSlots(), rhs.size_);
+        }
+        return *this;
+    }
+
+    StaticStorage& operator=(StaticStorage&& rhs) noexcept(std::is_nothrow_move_assignable_v<T>
+                                                           && std::is_nothrow_move_constructible_v<T>) {
+        if (this != &rhs) {
+            Assign(std::make_move_iterator(rhs.GetSlots()), rhs.size_);
+        }
+        return *this;
+    }
+
+    ~StaticStorage() {
+        std::destroy_n(GetSlots(), size_);
+    }
+
+    T* GetSlots() noexcept {
+        return std::launder(reinterpret_cast<T*>(buffer_));
+    }
+    const T* GetSlots() const noexcept {
+        return std::launder(reinterpret_cast<const T*>(buffer_));
+    }
+
+    alignas(T) unsigned char buffer_[sizeof(T) * (N == 0 ? 1 : N)];
+    size_t size_ = 0;
+
+private:
+    // Присваивает элементам общей части, а недостающие создаёт или лишние уничтожает
+    template <typename It>
+    void Assign(It first, size_t count) {
+        T* slots = GetSlots();
+        const size_t common = std::min(size_, count);
+        std::copy_n(first, common, slots);
+        if (count < size_) {
+            std::destroy_n(slots + count, size_ - count);
+        } else {
+            std::uninitialized_copy_n(first + common, count - common, slots + common);
+        }
+        size_ = count;
+    }
+};
+
+}  // namespace detail
+
+// Вектор вместимостью не более N элементов, хранящий их внутри самого объекта и никогда
+// не обращающийся к куче. Интерфейс повторяет Vector; при переполнении PushBack и Insert
+// выбрасывают std::length_error, а TryPushBack и TryEmplaceBack сообщают о нём результатом.
+// Для тривиальных типов все операции constexpr, что позволяет строить таблицы при компиляции
+template <typename T, size_t N>
+class StaticVector : private detail::StaticStorage<T, N> {
+    static constexpr bool IS_TRIVIAL = std::is_trivial_v<T>;
+
+public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    static constexpr size_t CAPACITY = N;
+
+    StaticVector() = default;
+
+    constexpr explicit StaticVector(size_t size) {
+        Resize(size);
+    }
+
+    constexpr StaticVector(std::initializer_list<T> values) {
+        Insert(end(), values.begin(), values.end());
+    }
+
+    constexpr iterator begin() noexcept {
+        return this->GetSlots();
+    }
+    constexpr iterator end() noexcept {
+        return this->GetSlots() + this->size_;
+    }
+    constexpr const_iterator begin() const noexcept {
+        return this->GetSlots();
+    }
+    constexpr const_iterator end() const noexcept {
+        return this->GetSlots() + this->size_;
+    }
+    constexpr const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    constexpr const_iterator cend() const noexcept {
+        return end();
+    }
+
+    constexpr T* Data() noexcept {
+        return this->GetSlots();
+    }
+    constexpr const T* Data() const noexcept {
+        return this->GetSlots();
+    }
+
+    constexpr size_t Size() const noexcept {
+        return this->size_;
+    }
+
+    static constexpr size_t Capacity() noexcept {
+        return N;
+    }
+
+    static constexpr size_t MaxSize() noexcept {
+        return N;
+    }
+
+    constexpr const T& operator[](size_t index) const noexcept {
+        assert(index < this->size_);
+        return this->GetSlots()[index];
+    }
+
+    constexpr T& operator[](size_t index) noexcept {
+        assert(index < this->size_);
+        return this->GetSlots()[index];
+    }
+
+    // Память не выделяется, поэтому только проверяет, что new_capacity элементов поместятся
+    constexpr void Reserve(size_t new_capacity) const {
+        if (new_capacity > N) {
+            VECTOR_THROW(std::length_error("StaticVector capacity exceeded"));
+        }
+    }
+
+    constexpr void Resize(size_t new_size) {
+        Reserve(new_size);
+        if (new_size < this->size_) {
+            DestroyTail(new_size);
+            return;
+        }
+        while (this->size_ < new_size) {
+            ConstructAt(this->size_);
+            ++this->size_;
+        }
+    }
+
+    constexpr void Clear() noexcept {
+        DestroyTail(0);
+    }
+
+    template <typename... Args>
+    constexpr T& EmplaceBack(Args&&... args) {
+        Reserve(this->size_ + 1);
+        T& result = *ConstructAt(this->size_, std::forward<Args>(args)...);
+        ++this->size_;
+        return result;
+    }
+
+    constexpr void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    constexpr void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    // Возвращает адрес нового элемента или nullptr, если вектор заполнен
+    template <typename... Args>
+    constexpr T* TryEmplaceBack(Args&&... args) {
+        if (this->size_ == N) {
+            return nullptr;
+        }
+        T* result = ConstructAt(this->size_, std::forward<Args>(args)...);
+        ++this->size_;
+        return result;
+    }
+
+    constexpr bool TryPushBack(const T& value) {
+        return TryEmplaceBack(value) != nullptr;
+    }
+
+    constexpr bool TryPushBack(T&& value) {
+        return TryEmplaceBack(std::move(value)) != nullptr;
+    }
+
+    constexpr void PopBack() noexcept {
+        assert(this->size_ != 0);
+        DestroyTail(this->size_ - 1);
+    }
+
+    template <typename... Args>
+    constexpr iterator Emplace(const_iterator pos, Args&&... args) {
+        const size_t offset = pos - cbegin();
+        EmplaceBack(std::forward<Args>(args)...);
+        Rotate(offset, this->size_ - 1);
+        return begin() + offset;
+    }
+
+    constexpr iterator Insert(const_iterator pos, const T& value) {
+        return Emplace(pos, value);
+    }
+
+    constexpr iterator Insert(const_iterator pos, T&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    // При переполнении или исключении конструктора элемента вектор остаётся прежним
+    template <typename InputIt, typename = detail::RequireInputIterator<InputIt>>
+    constexpr iterator Insert(const_iterator pos, InputIt first, InputIt last) {
+        const size_t offset = pos - cbegin();
+        const size_t old_size = this->size_;
+        if constexpr (detail::IS_ITERATOR_OF_CATEGORY<InputIt, std::forward_iterator_tag>) {
+            // Переполнение обнаруживается до вставки первого элемента
+            Reserve(old_size + static_cast<size_t>(std::distance(first, last)));
+        }
+        for (; first != last; ++first) {
+            if (this->size_ == N) {
+                // Итератор ввода нельзя пройти заранее, поэтому уже добавленные элементы удаляются
+                DestroyTail(old_size);
+                VECTOR_THROW(std::length_error("StaticVector capacity exceeded"));
+            }
+            if constexpr (IS_TRIVIAL) {
+                EmplaceBack(*first);
+            } else {
+                EmplaceBackOrRollback(old_size, *first);
+            }
+        }
+        Rotate(offset, old_size);
+        return begin() + offset;
+    }
+
+    constexpr iterator Erase(const_iterator pos) {
+        return Erase(pos, pos + 1);
+    }
+
+    constexpr iterator Erase(const_iterator first, const_iterator last) {
+        const size_t offset = first - cbegin();
+        const size_t count = last - first;
+        T* slots = this->GetSlots();
+        for (size_t i = offset; i + count < this->size_; ++i) {
+            slots[i] = std::move(slots[i + count]);
+        }
+        DestroyTail(this->size_ - count);
+        return begin() + offset;
+    }
+
+    constexpr void Swap(StaticVector& other) {
+        std::swap(*this, other);
+    }
+
+    friend constexpr bool operator==(const StaticVector& lhs, const StaticVector& rhs) {
+        if (lhs.Size() != rhs.Size()) {
+            return false;
+        }
+        for (size_t i = 0; i != lhs.Size(); ++i) {
+            if (!(lhs[i] == rhs[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    friend constexpr bool operator!=(const StaticVector& lhs, const StaticVector& rhs) {
+        return !(lhs == rhs);
+    }
+
+private:
+    template <typename... Args>
+    constexpr T* ConstructAt(size_t index, Args&&... args) {
+        T* slot = this->GetSlots() + index;
+        if constexpr (IS_TRIVIAL) {
+            if constexpr (std::is_constructible_v<T, Args&&...>) {
+                *slot = T(std::forward<Args>(args)...);
+            } else {
+                *slot = T{std::forward<Args>(args)...};
+            }
+            return slot;
+        } else {
+            return new (slot) T(std::forward<Args>(args)...);
+        }
+    }
+
+    // Вне constexpr-функций, поскольку до C++20 они не могут содержать try
+    template <typename Arg>
+    void EmplaceBackOrRollback(size_t old_size, Arg&& arg) {
+        VECTOR_TRY {
+            ConstructAt(this->size_, std::forward<Arg>(arg));
+        } VECTOR_CATCH_ALL {
+            DestroyTail(old_size);
+            VECTOR_RETHROW;
+        }
+        ++this->size_;
+    }
+
+    constexpr void DestroyTail(size_t new_size) noexcept {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            std::destroy_n(this->GetSlots() + new_size, this->size_ - new_size);
+        }
+        this->size_ = new_size;
+    }
+
+    // Переставляет элементы [middle, size_) перед элементом offset
+    constexpr void Rotate(size_t offset, size_t middle) {
+        T* slots = this->GetSlots();
+        if constexpr (IS_TRIVIAL) {
+            // Циклический сдвиг тремя разворотами, допустимый в константных выражениях C++17
+            const auto reverse = [slots](size_t first, size_t last) {
+                for (; first + 1 < last; ++first, --last) {
+                    const T temp = slots[first];
+                    slots[first] = slots[last - 1];
+                    slots[last - 1] = temp;
+                }
+            };
+            reverse(offset, middle);
+            reverse(middle, this->size_);
+            reverse(offset, this->size_);
+        } else {
+            std::rotate(slots + offset, slots + middle, slots + this->size_);
+        }
+    }
+};
@@ -1,39 +1,186 @@
 #pragma once
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <exception>
+#include <iterator>
 #include <new>
+#include <stdexcept>
+#include <thread>
 #include <utility>
 #include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include <vector>
+
+// Сборка без исключений (-fno-exceptions). Блоки отката компилируются только при включённых
+// исключениях, а ошибки, о которых сообщает исключение, завершают программу через std::abort
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS)
+#define VECTOR_HAS_EXCEPTIONS 1
+#define VECTOR_TRY try
+#define VECTOR_CATCH_ALL catch (...)
+#define VECTOR_RETHROW throw
+#define VECTOR_THROW(exception) throw exception
+#else
+#define VECTOR_HAS_EXCEPTIONS 0
+#define VECTOR_TRY if (true)
+#define VECTOR_CATCH_ALL else
+#define VECTOR_RETHROW static_cast<void>(0)
+#define VECTOR_THROW(exception) std::abort()
+#endif
+
+// Отладочный режим (-DVECTOR_DEBUG). Итераторы BasicVector запоминают поколение вектора — счётчик
+// смен буфера — и аварийно завершают программу при обращении через итератор, полученный до реаллокации,
+// или за пределы элементов, даже при NDEBUG. Под AddressSanitizer неиспользуемая часть буфера вдобавок
+// помечается недоступной. Без VECTOR_DEBUG итераторы остаются указателями, а проверки не компилируются
+#if !defined(VECTOR_DEBUG)
+#define VECTOR_DEBUG 0
+#endif
+
+#if defined(__SANITIZE_ADDRESS__)
+#define VECTOR_HAS_ASAN 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define VECTOR_HAS_ASAN 1
+#endif
+#endif
+
+#if VECTOR_DEBUG && defined(VECTOR_HAS_ASAN)
+#define VECTOR_ANNOTATE_CONTAINER 1
+#include <sanitizer/common_interface_defs.h>
+#else
+#define VECTOR_ANNOTATE_CONTAINER 0
+#endif
+
+#if VECTOR_DEBUG
+#define VECTOR_DEBUG_CHECK(condition, message) \
+    ((condition) ? static_cast<void>(0) : ::detail::DebugCheckFailed(__FILE__, __LINE__, message))
+#endif
+
+// Тип считается тривиально перемещаемым, если объект можно перенести в другую область памяти
+// побайтовым копированием, не вызывая деструктор у исходного объекта.
+// Для пользовательских типов (например, владеющих ресурсом через указатель) допускается
+// явная специализация: template <> struct IsTriviallyRelocatable<MyType> : std::true_type {};
+template <typename T>
+struct IsTriviallyRelocatable : std::is_trivially_copyable<T> {};
 
 template <typename T>
+struct IsTriviallyRelocatable<std::unique_ptr<T>> : std::true_type {};
+
+// Результат выделения памяти: адрес блока и фактическое число элементов, которое в нём помещается
+template <typename T>
+struct AllocationResult {
+    T* ptr = nullptr;
+    size_t count = 0;
+};
+
+// Буфер, от владения которым отказался вектор: size живых элементов в блоке из capacity ячеек
+template <typename T>
+struct ReleasedBuffer {
+    T* ptr = nullptr;
+    size_t size = 0;
+    size_t capacity = 0;
+};
+
+namespace detail {
+
+// Необязательные расширения интерфейса аллокатора:
+//   allocate_at_least(n) -> AllocationResult<T>     выделяет блок не менее чем под n элементов
+//   expand(p, old_n, n) -> size_t                   расширяет блок на месте, возвращая новую ёмкость или 0
+//   reallocate(p, old_n, n) -> AllocationResult<T>  переносит блок побайтово, как realloc
+template <typename Allocator, typename = void>
+struct HasAllocateAtLeast : std::false_type {};
+
+template <typename Allocator>
+struct HasAllocateAtLeast<Allocator, std::void_t<decltype(std::declval<Allocator&>().allocate_at_least(size_t{}))>>
+    : std::true_type {};
+
+template <typename Allocator, typename = void>
+struct HasExpand : std::false_type {};
+
+template <typename Allocator>
+struct HasExpand<Allocator, std::void_t<decltype(std::declval<Allocator&>().expand(
+                                std::declval<typename Allocator::value_type*>(), size_t{}, size_t{}))>>
+    : std::true_type {};
+
+template <typename Allocator, typename = void>
+struct HasReallocate : std::false_type {};
+
+template <typename Allocator>
+struct HasReallocate<Allocator, std::void_t<decltype(std::declval<Allocator&>().reallocate(
+                                    std::declval<typename Allocator::value_type*>(), size_t{}, size_t{}))>>
+    : std::true_type {};
+
+}  // namespace detail
+
+template <typename T, typename Allocator = std::allocator<T>>
 class RawMemory {
+    using AllocTraits = std::allocator_traits<Allocator>;
+
+    static_assert(std::is_same_v<typename AllocTraits::value_type, T>, "Allocator::value_type must be T");
+    static_assert(std::is_same_v<typename AllocTraits::pointer, T*>, "Fancy pointers are not supported");
+
 public:
+    using allocator_type = Allocator;
+
+    // Число элементов, размещаемых внутри самого объекта без обращения к аллокатору
+    static constexpr size_t INLINE_CAPACITY = 0;
+
+    // Поддерживает ли аллокатор расширение блока на месте и побайтовый перенос блока
+    static constexpr bool CAN_EXPAND = detail::HasExpand<Allocator>::value;
+    static constexpr bool CAN_REALLOCATE = detail::HasReallocate<Allocator>::value;
+
     RawMemory() = default;
 
-    explicit RawMemory(size_t capacity)
-        : buffer_(Allocate(capacity))
+    explicit RawMemory(const Allocator& alloc) noexcept
+        : alloc_(alloc) {
+    }
+
+    // Фактическая вместимость может превышать capacity, если аллокатор сообщает размер выделенного блока
+    explicit RawMemory(size_t capacity, const Allocator& alloc = Allocator())
+        : alloc_(alloc) {
+        const AllocationResult<T> allocation = Allocate(capacity);
+        buffer_ = allocation.ptr;
+        capacity_ = allocation.count;
+    }
+
+    // Принимает во владение блок buffer из capacity ячеек, выделенный аллокатором, равным alloc
+    RawMemory(T* buffer, size_t capacity, const Allocator& alloc) noexcept
+        : alloc_(alloc)
+        , buffer_(buffer)
         , capacity_(capacity) {
     }
 
     ~RawMemory() {
-        Deallocate(buffer_);
+        Deallocate(buffer_, capacity_);
     }
 
     RawMemory(const RawMemory&) = delete;
     RawMemory& operator=(const RawMemory& rhs) = delete;
 
-    RawMemory(RawMemory&& other) noexcept { 
-        buffer_ = other.buffer_;
-        capacity_ = other.capacity_;
-        other.buffer_ = nullptr;
-        other.capacity_ = 0;
+    RawMemory(RawMemory&& other) noexcept
+        : alloc_(std::move(other.alloc_))
+        , buffer_(std::exchange(other.buffer_, nullptr))
+        , capacity_(std::exchange(other.capacity_, 0)) {
     }
 
+    // Аллокатор переходит к *this, только если того требует propagate_on_container_move_assignment,
+    // иначе аллокаторы обязаны быть равны
     RawMemory& operator=(RawMemory&& rhs) noexcept {
-        buffer_ = rhs.buffer_;
-        capacity_ = rhs.capacity_;
-        rhs.buffer_ = nullptr;
-        rhs.capacity_ = 0;
+        if (this != &rhs) {
+            Deallocate(buffer_, capacity_);
+            if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+                alloc_ = std::move(rhs.alloc_);
+            } else {
+                assert(alloc_ == rhs.alloc_);
+            }
+            buffer_ = std::exchange(rhs.buffer_, nullptr);
+            capacity_ = std::exchange(rhs.capacity_, 0);
+        }
         return *this;
     }
 
@@ -52,15 +199,100 @@ public:
     }
 
     T& operator[](size_t index) noexcept {
-        assert(index <= capacity_);
+        assert(index < capacity_);
         return buffer_[index];
     }
 
+    // Аллокаторы обмениваются, только если того требует propagate_on_container_swap,
+    // иначе они обязаны быть равны
     void Swap(RawMemory& other) noexcept {
+        if constexpr (AllocTraits::propagate_on_container_swap::value) {
+            std::swap(alloc_, other.alloc_);
+        } else {
+            assert(alloc_ == other.alloc_);
+        }
         std::swap(buffer_, other.buffer_);
         std::swap(capacity_, other.capacity_);
     }
 
+    // Освобождает буфер и заменяет аллокатор на alloc
+    void ResetAllocator(const Allocator& alloc) noexcept {
+        Deallocate(buffer_, capacity_);
+        buffer_ = nullptr;
+        capacity_ = 0;
+        alloc_ = alloc;
+    }
+
+    // Пытается расширить текущий блок на месте до new_capacity элементов. Адрес элементов не меняется
+    bool TryExpand(size_t new_capacity) noexcept {
+        if constexpr (CAN_EXPAND) {
+            if (buffer_ == nullptr) {
+                return false;
+            }
+            const size_t count = alloc_.expand(buffer_, capacity_, new_capacity);
+            if (count < new_capacity) {
+                return false;
+            }
+            capacity_ = count;
+            return true;
+        } else {
+            return false;
+        }
+    }
+
+    // Переносит содержимое блока побайтово в блок из new_capacity элементов, как это делает realloc.
+    // Допустимо только для тривиально перемещаемых типов. Возвращает false, если аллокатор
+    // не поддерживает такое перемещение
+    bool TryReallocate(size_t new_capacity) {
+        if constexpr (CAN_REALLOCATE) {
+            static_assert(IsTriviallyRelocatable<T>::value, "Elements must be trivially relocatable");
+            const AllocationResult<T> allocation = buffer_ == nullptr
+                ? Allocate(new_capacity)
+                : alloc_.reallocate(buffer_, capacity_, new_capacity);
+            buffer_ = allocation.ptr;
+            capacity_ = allocation.count;
+            return true;
+        } else {
+            return false;
+        }
+    }
+
+    // Выделяет блок не менее чем под capacity элементов в пустом объекте. При нехватке памяти
+    // возвращает false вместо исключения. Память std::allocator запрашивается через nothrow-версию
+    // operator new, поэтому функция работает и в сборке без исключений
+    bool TryAllocate(size_t capacity) noexcept {
+        assert(buffer_ == nullptr);
+        if (capacity == 0) {
+            return true;
+        }
+        if (capacity > AllocTraits::max_size(alloc_)) {
+            return false;
+        }
+        if constexpr (std::is_same_v<Allocator, std::allocator<T>>) {
+            void* ptr;
+            if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+                ptr = ::operator new(capacity * sizeof(T), std::align_val_t{alignof(T)}, std::nothrow);
+            } else {
+                ptr = ::operator new(capacity * sizeof(T), std::nothrow);
+            }
+            if (ptr == nullptr) {
+                return false;
+            }
+            buffer_ = static_cast<T*>(ptr);
+            capacity_ = capacity;
+        } else {
+            AllocationResult<T> allocation;
+            VECTOR_TRY {
+                allocation = Allocate(capacity);
+            } VECTOR_CATCH_ALL {
+                return false;
+            }
+            buffer_ = allocation.ptr;
+            capacity_ = allocation.count;
+        }
+        return buffer_ != nullptr;
+    }
+
     const T* GetAddress() const noexcept {
         return buffer_;
     }
@@ -69,60 +301,441 @@ public:
         return buffer_;
     }
 
+    // Отказывается от владения блоком и возвращает его адрес
+    T* Release() noexcept {
+        capacity_ = 0;
+        return std::exchange(buffer_, nullptr);
+    }
+
     size_t Capacity() const {
         return capacity_;
     }
 
+    const Allocator& GetAllocator() const noexcept {
+        return alloc_;
+    }
+
 private:
-    // Выделяет сырую память под n элементов и возвращает указатель на неё
-    static T* Allocate(size_t n) {
-        return n != 0 ? static_cast<T*>(operator new(n * sizeof(T))) : nullptr;
+    // Выделяет сырую память не менее чем под n элементов
+    AllocationResult<T> Allocate(size_t n) {
+        if (n == 0) {
+            return {};
+        }
+        if constexpr (detail::HasAllocateAtLeast<Allocator>::value) {
+            const auto allocation = alloc_.allocate_at_least(n);
+            return {allocation.ptr, allocation.count};
+        } else {
+            return {AllocTraits::allocate(alloc_, n), n};
+        }
     }
 
-    // Освобождает сырую память, выделенную ранее по адресу buf при помощи Allocate
-    static void Deallocate(T* buf) noexcept {
-        operator delete(buf);
+    // Освобождает сырую память под n элементов, выделенную ранее по адресу buf при помощи Allocate
+    void Deallocate(T* buf, size_t n) noexcept {
+        if (buf != nullptr) {
+            AllocTraits::deallocate(alloc_, buf, n);
+        }
     }
 
+    [[no_unique_address]] Allocator alloc_;
     T* buffer_ = nullptr;
     size_t capacity_ = 0;
 };
 
+// Стратегии роста вектора. NextCapacity<T>(capacity, required) возвращает новую вместимость,
+// которая не меньше required, когда текущей вместимости capacity недостаточно
+
+// Удвоение вместимости
+struct DoublingGrowth {
+    template <typename T>
+    static size_t NextCapacity(size_t capacity, size_t required) noexcept {
+        return std::max(required, capacity == 0 ? 1 : capacity * 2);
+    }
+};
+
+// Рост в 1.5 раза. Сумма ранее освобождённых блоков со временем превышает размер очередного запроса,
+// поэтому аллокатор может переиспользовать их
+struct GoldenGrowth {
+    template <typename T>
+    static size_t NextCapacity(size_t capacity, size_t required) noexcept {
+        return std::max(required, capacity == 0 ? 1 : capacity + (capacity + 1) / 2);
+    }
+};
+
+// Первое выделение памяти занимает как минимум одну кеш-линию, дальнейший рост определяется Base
+template <typename Base = DoublingGrowth, size_t CacheLineSize = 64>
+struct CacheLineGrowth {
+    template <typename T>
+    static size_t NextCapacity(size_t capacity, size_t required) noexcept {
+        constexpr size_t min_capacity = std::max<size_t>(1, CacheLineSize / sizeof(T));
+        return std::max(min_capacity, Base::template NextCapacity<T>(capacity, required));
+    }
+};
+
+// Буферы размером от Threshold байт округляются вверх до целого числа страниц, чтобы не терять
+// память, которую аллокатор всё равно выделит
+template <typename Base = DoublingGrowth, size_t PageSize = 4096, size_t Threshold = 64 * 1024>
+struct PageGrowth {
+    template <typename T>
+    static size_t NextCapacity(size_t capacity, size_t required) noexcept {
+        const size_t new_capacity = Base::template NextCapacity<T>(capacity, required);
+        const size_t bytes = new_capacity * sizeof(T);
+        if (bytes < Threshold) {
+            return new_capacity;
+        }
+        const size_t page_bytes = (bytes + PageSize - 1) / PageSize * PageSize;
+        return page_bytes / sizeof(T);
+    }
+};
+
+// Политика сбора статистики. Вектор сообщает ей о событиях, влияющих на производительность:
+//   OnReallocate(old_capacity, new_capacity)  элементы перенесены в новый буфер
+//   OnExpand(old_capacity, new_capacity)      буфер расширен на месте
+//   OnRelocate(bytes)                         при реаллокации перемещено bytes байт элементов
+//   OnCopy(bytes)                             при копировании вектора скопировано bytes байт элементов
+//   OnCopyFallback(bytes)                     при реаллокации элементы скопированы, так как
+//                                             их перемещение может выбросить исключение
+//   OnDestroy(size, capacity)                 вектор уничтожен, capacity - size ячеек не использовались
+// NoStats ничего не делает, и вызовы её методов исчезают после встраивания.
+// Реализация со счётчиками находится в vector_stats.h
+struct NoStats {
+    static void OnReallocate(size_t /*old_capacity*/, size_t /*new_capacity*/) noexcept {
+    }
+    static void OnExpand(size_t /*old_capacity*/, size_t /*new_capacity*/) noexcept {
+    }
+    static void OnRelocate(size_t /*bytes*/) noexcept {
+    }
+    static void OnCopy(size_t /*bytes*/) noexcept {
+    }
+    static void OnCopyFallback(size_t /*bytes*/) noexcept {
+    }
+    static void OnDestroy(size_t /*size*/, size_t /*capacity*/) noexcept {
+    }
+};
+
+namespace detail {
+
+// Итератор, возвращающий одно и то же значение на каждой позиции. Позволяет вставить n копий
+// значения тем же кодом, что и диапазон
 template <typename T>
-class Vector {
+class RepeatIterator {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = const T&;
+
+    RepeatIterator() = default;
+
+    explicit RepeatIterator(const T& value, difference_type index = 0) noexcept
+        : value_(&value)
+        , index_(index) {
+    }
+
+    reference operator*() const noexcept {
+        return *value_;
+    }
+    pointer operator->() const noexcept {
+        return value_;
+    }
+
+    RepeatIterator& operator++() noexcept {
+        ++index_;
+        return *this;
+    }
+    RepeatIterator operator++(int) noexcept {
+        RepeatIterator old(*this);
+        ++index_;
+        return old;
+    }
+
+    bool operator==(const RepeatIterator& rhs) const noexcept {
+        return index_ == rhs.index_;
+    }
+    bool operator!=(const RepeatIterator& rhs) const noexcept {
+        return index_ != rhs.index_;
+    }
+
+private:
+    const T* value_ = nullptr;
+    difference_type index_ = 0;
+};
+
+template <typename It, typename Category, typename = void>
+struct IsIteratorOfCategory : std::false_type {};
+
+template <typename It, typename Category>
+struct IsIteratorOfCategory<It, Category, std::void_t<typename std::iterator_traits<It>::iterator_category>>
+    : std::is_base_of<Category, typename std::iterator_traits<It>::iterator_category> {};
+
+template <typename It, typename Category>
+inline constexpr bool IS_ITERATOR_OF_CATEGORY = IsIteratorOfCategory<It, Category>::value;
+
+template <typename It>
+using RequireInputIterator = std::enable_if_t<IS_ITERATOR_OF_CATEGORY<It, std::input_iterator_tag>>;
+
+}  // namespace detail
+
+// Тег конструктора, создающего элементы инициализацией по умолчанию. Для тривиальных типов
+// память не заполняется нулями, и значения элементов не определены до первой записи
+struct DefaultInitTag {
+    explicit DefaultInitTag() = default;
+};
+
+inline constexpr DefaultInitTag DEFAULT_INIT{};
+
+// Параметры параллельного создания, копирования и уничтожения элементов. Диапазон делится на
+// части не меньше min_chunk_size элементов, каждую из которых обрабатывает свой поток. Память
+// нового буфера впервые записывается тем потоком, который обрабатывает её часть, поэтому
+// на NUMA-системах страницы распределяются между узлами этих потоков
+struct ParallelPolicy {
+    // 0 означает std::thread::hardware_concurrency()
+    size_t num_threads = 0;
+    size_t min_chunk_size = size_t{1} << 16;
+};
+
+inline constexpr ParallelPolicy PARALLEL{};
+
+namespace detail {
+
+// Число частей, на которые ParallelFor делит диапазон из count элементов
+inline size_t GetChunkCount(const ParallelPolicy& policy, size_t count) {
+    const size_t max_threads = policy.num_threads != 0
+        ? policy.num_threads
+        : std::max<size_t>(1, std::thread::hardware_concurrency());
+    return std::min(max_threads, std::max<size_t>(1, count / std::max<size_t>(1, policy.min_chunk_size)));
+}
+
+// Начало части chunk из num_chunks почти равных частей диапазона из count элементов
+inline size_t GetChunkBegin(size_t count, size_t num_chunks, size_t chunk) noexcept {
+    return count / num_chunks * chunk + std::min(chunk, count % num_chunks);
+}
+
+// Применяет construct(first, last) к частям диапазона [0, count) в нескольких потоках.
+// construct должен либо обработать свою часть целиком, либо откатить её сам и выбросить исключение.
+// Если исключение выбросила хотя бы одна часть, к успешно обработанным частям применяется
+// rollback(first, last), после чего первое исключение пробрасывается дальше
+template <typename Construct, typename Rollback>
+void ParallelFor(const ParallelPolicy& policy, size_t count, Construct construct, Rollback rollback) {
+    const size_t num_chunks = GetChunkCount(policy, count);
+    if (num_chunks <= 1) {
+        construct(size_t{0}, count);
+        return;
+    }
+    const auto chunk_begin = [count, num_chunks](size_t chunk) {
+        return GetChunkBegin(count, num_chunks, chunk);
+    };
+    std::vector<std::exception_ptr> errors(num_chunks);
+    const auto run_chunk = [&](size_t chunk) noexcept {
+        VECTOR_TRY {
+            construct(chunk_begin(chunk), chunk_begin(chunk + 1));
+        } VECTOR_CATCH_ALL {
+            errors[chunk] = std::current_exception();
+        }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(num_chunks - 1);
+    for (size_t chunk = 1; chunk != num_chunks; ++chunk) {
+        VECTOR_TRY {
+            threads.emplace_back(run_chunk, chunk);
+        } VECTOR_CATCH_ALL {
+            // Поток не создан, часть обрабатывается текущим потоком
+            run_chunk(chunk);
+        }
+    }
+    run_chunk(0);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    const auto first_error = std::find_if(errors.begin(), errors.end(), [](const std::exception_ptr& error) {
+        return error != nullptr;
+    });
+    if (first_error == errors.end()) {
+        return;
+    }
+    for (size_t chunk = 0; chunk != num_chunks; ++chunk) {
+        if (errors[chunk] == nullptr) {
+            rollback(chunk_begin(chunk), chunk_begin(chunk + 1));
+        }
+    }
+    std::rethrow_exception(*first_error);
+}
+
+#if VECTOR_DEBUG
+
+[[noreturn]] inline void DebugCheckFailed(const char* file, int line, const char* message) noexcept {
+    std::fprintf(stderr, "%s:%d: %s\n", file, line, message);
+    std::abort();
+}
+
+template <typename N>
+using RequireIntegral = std::enable_if_t<std::is_integral_v<N>>;
+
+// Итератор BasicVector в отладочном режиме. Итератор, созданный из указателя, ничего не проверяет.
+// Неявно приводится к указателю, поэтому сравнения и разности итераторов работают как у указателей,
+// а смещения принимают любой целый тип, чтобы не конкурировать со встроенными операциями
+template <typename T, typename Owner>
+class CheckedIterator {
 public:
+    using iterator_category = std::random_access_iterator_tag;
+#if __cplusplus >= 202002L
+    using iterator_concept = std::contiguous_iterator_tag;
+#endif
+    using value_type = std::remove_cv_t<T>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T*;
+    using reference = T&;
+
+    CheckedIterator() = default;
+
+    CheckedIterator(T* ptr) noexcept
+        : ptr_(ptr) {
+    }
+
+    CheckedIterator(T* ptr, const Owner* owner) noexcept
+        : ptr_(ptr)
+        , owner_(owner)
+        , generation_(owner->GetGeneration()) {
+    }
+
+    template <typename U, typename = std::enable_if_t<std::is_same_v<const U, T> && !std::is_same_v<U, T>>>
+    CheckedIterator(const CheckedIterator<U, Owner>& other) noexcept
+        : ptr_(other.ptr_)
+        , owner_(other.owner_)
+        , generation_(other.generation_) {
+    }
+
+    operator T*() const noexcept {
+        Check(0, true);
+        return ptr_;
+    }
+
+    T& operator*() const noexcept {
+        Check(0, false);
+        return *ptr_;
+    }
+
+    T* operator->() const noexcept {
+        Check(0, false);
+        return ptr_;
+    }
+
+    template <typename N, typename = RequireIntegral<N>>
+    T& operator[](N offset) const noexcept {
+        Check(static_cast<difference_type>(offset), false);
+        return ptr_[offset];
+    }
+
+    CheckedIterator& operator++() noexcept {
+        ++ptr_;
+        return *this;
+    }
+
+    CheckedIterator operator++(int) noexcept {
+        CheckedIterator old = *this;
+        ++ptr_;
+        return old;
+    }
+
+    CheckedIterator& operator--() noexcept {
+        --ptr_;
+        return *this;
+    }
+
+    CheckedIterator operator--(int) noexcept {
+        CheckedIterator old = *this;
+        --ptr_;
+        return old;
+    }
+
+    template <typename N, typename = RequireIntegral<N>>
+    CheckedIterator& operator+=(N offset) noexcept {
+        ptr_ += offset;
+        return *this;
+    }
+
+    template <typename N, typename = RequireIntegral<N>>
+    CheckedIterator& operator-=(N offset) noexcept {
+        ptr_ -= offset;
+        return *this;
+    }
+
+    template <typename N, typename = RequireIntegral<N>>
+    friend CheckedIterator operator+(CheckedIterator it, N offset) noexcept {
+        return it += offset;
+    }
+
+    template <typename N, typename = RequireIntegral<N>>
+    friend CheckedIterator operator+(N offset, CheckedIterator it) noexcept {
+        return it += offset;
+    }
+
+    template <typename N, typename = RequireIntegral<N>>
+    friend CheckedIterator operator-(CheckedIterator it, N offset) noexcept {
+        return it -= offset;
+    }
+
+private:
+    template <typename, typename>
+    friend class CheckedIterator;
+
+    // Проверяет, что буфер вектора не менялся и что ptr_ + offset указывает на элемент
+    // или, если allow_end, на позицию за последним элементом
+    void Check(difference_type offset, bool allow_end) const noexcept {
+        if (owner_ == nullptr) {
+            return;
+        }
+        VECTOR_DEBUG_CHECK(generation_ == owner_->GetGeneration(), "Vector iterator is invalidated by reallocation");
+        const difference_type index = ptr_ - owner_->Data() + offset;
+        const difference_type end = static_cast<difference_type>(owner_->Size()) + (allow_end ? 1 : 0);
+        VECTOR_DEBUG_CHECK(index >= 0 && index < end, "Vector iterator is out of range");
+    }
+
+    T* ptr_ = nullptr;
+    const Owner* owner_ = nullptr;
+    size_t generation_ = 0;
+};
 
+#endif
+
+}  // namespace detail
+
+// Общая реализация вектора. Storage владеет сырой памятью (RawMemory или её аналог со встроенным
+// буфером) и при реаллокации принимает новый буфер RawMemory через Swap
+template <typename T, typename Storage, typename GrowthPolicy, typename Stats = NoStats>
+class BasicVector {
+    using Allocator = typename Storage::allocator_type;
+    using AllocTraits = std::allocator_traits<Allocator>;
+
+    static constexpr bool HAS_INLINE_BUFFER = Storage::INLINE_CAPACITY != 0;
+
+    // Перенос элементов в новый буфер не выбрасывает исключений, поэтому ветки с копированием
+    // и откатом для таких типов не компилируются
+    static constexpr bool IS_NOTHROW_RELOCATABLE = IsTriviallyRelocatable<T>::value
+        || std::is_nothrow_move_constructible_v<T>;
+
+public:
+    using allocator_type = Allocator;
+#if VECTOR_DEBUG
+    using iterator = detail::CheckedIterator<T, BasicVector>;
+    using const_iterator = detail::CheckedIterator<const T, BasicVector>;
+#else
     using iterator = T*;
     using const_iterator = const T*;
+#endif
     
     iterator begin() noexcept {
-        if (Capacity() == 0) {
-            return nullptr;
-        } else {
-            return &data_[0];
-        }
+        return MakeIterator(data_.GetAddress());
     }
     iterator end() noexcept {
-        if (Capacity() == 0) {
-            return nullptr;
-        } else {
-            return &data_[size_];
-        }
+        return MakeIterator(data_ + size_);
     }
 
     const_iterator begin() const noexcept {
-        if (Capacity() == 0) {
-            return nullptr;
-        } else {
-            return const_cast<T*>(&data_[0]);
-        }
+        return MakeIterator(data_.GetAddress());
     }
     const_iterator end() const noexcept {
-        if (Capacity() == 0) {
-            return nullptr;
-        } else {
-            return const_cast<T*>(&data_[size_]);
-        }
+        return MakeIterator(data_ + size_);
     }
 
     const_iterator cbegin() const noexcept {
@@ -132,81 +745,320 @@ public:
         return end();
     }
 
-    Vector() = default;
+    BasicVector() = default;
+
+    explicit BasicVector(const Allocator& alloc) noexcept
+        : data_(alloc) {
+    }
 
-    explicit Vector(size_t size)
-        : data_(size)
+    explicit BasicVector(size_t size, const Allocator& alloc = Allocator())
+        : data_(size, alloc)
         , size_(size)
     {
         std::uninitialized_value_construct_n(data_.GetAddress(), size_);
+        AnnotateFrom(size_);
     }
 
-    ~Vector() {
+    BasicVector(size_t size, DefaultInitTag, const Allocator& alloc = Allocator())
+        : data_(size, alloc)
+        , size_(size)
+    {
+        std::uninitialized_default_construct_n(data_.GetAddress(), size_);
+        AnnotateFrom(size_);
+    }
+
+    // Создаёт элементы параллельно. При исключении уже созданные элементы уничтожаются
+    BasicVector(size_t size, ParallelPolicy policy, const Allocator& alloc = Allocator())
+        : data_(size, alloc)
+    {
+        T* data = data_.GetAddress();
+        detail::ParallelFor(policy, size,
+            [data](size_t first, size_t last) {
+                std::uninitialized_value_construct_n(data + first, last - first);
+            },
+            [data](size_t first, size_t last) noexcept {
+                std::destroy_n(data + first, last - first);
+            });
+        size_ = size;
+        AnnotateFrom(size_);
+    }
+
+    ~BasicVector() {
+        Stats::OnDestroy(size_, Capacity());
         std::destroy_n(data_.GetAddress(), size_);
+        AnnotateFrom(NOT_ANNOTATED);
     }
 
-    Vector(const Vector& other)
-        : data_(other.size_)
-        , size_(other.size_) 
+    BasicVector(const BasicVector& other)
+        : BasicVector(other, AllocTraits::select_on_container_copy_construction(other.GetAllocator())) {
+    }
+
+    BasicVector(const BasicVector& other, const Allocator& alloc)
+        : data_(other.size_, alloc)
+        , size_(other.size_)
     {
-        std::uninitialized_copy_n(other.data_.GetAddress(), other.Size(), data_.GetAddress());
+        UninitializedCopyN(other.data_.GetAddress(), other.Size(), data_.GetAddress());
+        AnnotateFrom(size_);
+        Stats::OnCopy(size_ * sizeof(T));
     }
 
-    Vector& operator=(const Vector& rhs) {
+    // Копирует элементы other параллельно
+    BasicVector(const BasicVector& other, ParallelPolicy policy)
+        : data_(other.size_, AllocTraits::select_on_container_copy_construction(other.GetAllocator()))
+    {
+        const T* from = other.data_.GetAddress();
+        T* to = data_.GetAddress();
+        detail::ParallelFor(policy, other.size_,
+            [from, to](size_t first, size_t last) {
+                UninitializedCopyN(from + first, last - first, to + first);
+            },
+            [to](size_t first, size_t last) noexcept {
+                std::destroy_n(to + first, last - first);
+            });
+        size_ = other.size_;
+        AnnotateFrom(size_);
+        Stats::OnCopy(size_ * sizeof(T));
+    }
+
+    BasicVector& operator=(const BasicVector& rhs) {
         if (this != &rhs) {
-            if (rhs.size_ > data_.Capacity()) {
-                Vector rhs_copy(rhs);
-                Swap(rhs_copy);
-            } else {
-                if (Size() > rhs.Size()) {
-                    for (size_t i = 0; i != rhs.Size(); ++i) {
-                        data_[i] = rhs[i];
-                    }
-                    std::destroy_n(data_.GetAddress() + rhs.Size(), Size() - rhs.Size());
-                } else {
-                    for (size_t i = 0; i != Size(); ++i) {
-                        data_[i] = rhs[i];
-                    }
-                    std::uninitialized_copy_n(rhs.data_.GetAddress() + Size(), rhs.Size() - Size(), data_.GetAddress() + Size());
+            if constexpr (AllocTraits::propagate_on_container_copy_assignment::value
+                          && !AllocTraits::is_always_equal::value) {
+                if (GetAllocator() != rhs.GetAllocator()) {
+                    // Память, выделенную текущим аллокатором, нельзя переиспользовать
+                    std::destroy_n(data_.GetAddress(), size_);
+                    size_ = 0;
+                    ReleaseBuffer();
+                    data_.ResetAllocator(rhs.GetAllocator());
                 }
             }
-            size_ = rhs.size_;
+            AssignRange(rhs.data_.GetAddress(), rhs.size_);
+            Stats::OnCopy(rhs.size_ * sizeof(T));
         }
         return *this;
     }
-    
 
-    Vector(Vector&& other) noexcept {
-        data_ = std::move(other.data_);
-        size_ = other.size_;
-        other.size_ = 0;
+    // Заменяет содержимое count копиями value, переиспользуя имеющуюся память
+    void Assign(size_t count, const T& value) {
+        // value может ссылаться на элемент самого вектора
+        const T value_copy(value);
+        AssignRange(detail::RepeatIterator<T>(value_copy), count);
     }
 
-    Vector& operator=(Vector&& rhs) noexcept {
+    // Заменяет содержимое элементами диапазона [first, last), который не должен ссылаться
+    // на элементы самого вектора
+    template <typename InputIt, typename = detail::RequireInputIterator<InputIt>>
+    void Assign(InputIt first, InputIt last) {
+        if constexpr (detail::IS_ITERATOR_OF_CATEGORY<InputIt, std::forward_iterator_tag>) {
+            AssignRange(first, static_cast<size_t>(std::distance(first, last)));
+        } else {
+            Clear();
+            for (; first != last; ++first) {
+                EmplaceBack(*first);
+            }
+        }
+    }
+
+    void Assign(std::initializer_list<T> values) {
+        AssignRange(values.begin(), values.size());
+    }
+
+
+    // Элементы из встроенного буфера other нельзя забрать вместе с памятью, поэтому они переносятся
+    // во встроенный буфер *this
+    BasicVector(BasicVector&& other) noexcept(!HAS_INLINE_BUFFER || std::is_nothrow_move_constructible_v<T>)
+        : data_(std::move(other.data_)) {
+        if constexpr (HAS_INLINE_BUFFER) {
+            if (data_.IsInline()) {
+                RelocateN(other.data_.GetAddress(), other.size_, data_.GetAddress());
+            }
+        }
+        size_ = std::exchange(other.size_, 0);
+        TakeAnnotation(other);
+    }
+
+    // Если аллокаторы не равны, элементы other перемещаются поштучно в память,
+    // выделенную при помощи alloc
+    BasicVector(BasicVector&& other, const Allocator& alloc)
+        : data_(alloc) {
+        if (!CanStealBuffer(other)) {
+            if (other.size_ > Capacity()) {
+                RawMemory<T, Allocator> new_data(other.size_, alloc);
+                data_.Swap(new_data);
+            }
+            std::uninitialized_move_n(other.data_.GetAddress(), other.size_, data_.GetAddress());
+            size_ = other.size_;
+            AnnotateFrom(size_);
+            return;
+        }
+        data_.Swap(other.data_);
+        size_ = std::exchange(other.size_, 0);
+        TakeAnnotation(other);
+    }
+
+    // Текущие элементы уничтожаются, а буфер освобождается при замене буфером rhs
+    BasicVector& operator=(BasicVector&& rhs) noexcept((AllocTraits::propagate_on_container_move_assignment::value
+                                              || AllocTraits::is_always_equal::value)
+                                             && (!HAS_INLINE_BUFFER || std::is_nothrow_move_constructible_v<T>)) {
+        if (this == &rhs) {
+            return *this;
+        }
+        if constexpr (!AllocTraits::propagate_on_container_move_assignment::value
+                      && !AllocTraits::is_always_equal::value) {
+            if (GetAllocator() != rhs.GetAllocator()) {
+                // Буфер rhs нельзя забрать, поэтому элементы перемещаются в память текущего аллокатора
+                BasicVector rhs_moved(std::move(rhs), GetAllocator());
+                Swap(rhs_moved);
+                return *this;
+            }
+        }
+        if constexpr (HAS_INLINE_BUFFER) {
+            if (rhs.data_.IsInline()) {
+                // Ёмкость *this не меньше встроенной, поэтому элементы rhs помещаются без реаллокации
+                const AnnotationScope scope(*this, rhs.size_);
+                rhs.InvalidateIterators();
+                std::destroy_n(data_.GetAddress(), size_);
+                size_ = 0;
+                RelocateN(rhs.data_.GetAddress(), rhs.size_, data_.GetAddress());
+                size_ = std::exchange(rhs.size_, 0);
+                return *this;
+            }
+        }
+        Clear();
+        ReleaseBuffer();
         data_ = std::move(rhs.data_);
-        size_ = rhs.size_;
-        rhs.size_ = 0;
+        size_ = std::exchange(rhs.size_, 0);
+        TakeAnnotation(rhs);
         return *this;
     }
 
-    void Swap(Vector& other) noexcept {
+    // Забирает элементы other, как перемещающее присваивание, но не освобождает память: *this остаётся
+    // с большим из двух буферов, а other — пустым с другим буфером. Пара векторов, которые по очереди
+    // заполняются и передают друг другу данные, обходится без повторных выделений памяти.
+    // Если больше буфер *this, элементы переносятся в него (тривиально перемещаемые — одним memcpy)
+    void Recycle(BasicVector&& other) {
+        if (this == &other) {
+            return;
+        }
+        const AnnotationScope scope(*this, other.size_);
+        const AnnotationScope other_scope(other, 0);
+        Clear();
+        if (CanStealBuffer(other) && other.Capacity() >= Capacity()) {
+            Swap(other);
+            return;
+        }
+        Reserve(other.size_);
+        if constexpr (IS_NOTHROW_RELOCATABLE) {
+            RelocateN(other.data_.GetAddress(), other.size_, data_.GetAddress());
+        } else {
+            std::uninitialized_move_n(other.data_.GetAddress(), other.size_, data_.GetAddress());
+            std::destroy_n(other.data_.GetAddress(), other.size_);
+        }
+        size_ = std::exchange(other.size_, 0);
+    }
+
+    void Swap(BasicVector& other) noexcept(!HAS_INLINE_BUFFER || std::is_nothrow_move_constructible_v<T>) {
+        if constexpr (HAS_INLINE_BUFFER) {
+            if (data_.IsInline() || other.data_.IsInline()) {
+                BasicVector temp(std::move(other));
+                other = std::move(*this);
+                *this = std::move(temp);
+                return;
+            }
+        }
         data_.Swap(other.data_);
         std::swap(size_, other.size_);
+#if VECTOR_ANNOTATE_CONTAINER
+        std::swap(annotated_size_, other.annotated_size_);
+#endif
+        InvalidateIterators();
+        other.InvalidateIterators();
+    }
+
+    const Allocator& GetAllocator() const noexcept {
+        return data_.GetAllocator();
     }
 
     void Reserve(size_t new_capacity) {
         if (new_capacity <= data_.Capacity()) {
             return;
         }
-        RawMemory<T> new_data(new_capacity);
-        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-            std::uninitialized_move_n(data_.GetAddress(), size_, new_data.GetAddress());
-        } else {
-            std::uninitialized_copy_n(data_.GetAddress(), size_, new_data.GetAddress());
+        const AnnotationScope scope(*this, size_);
+        if (TryExpand(new_capacity)) {
+            return;
         }
-        std::destroy_n(data_.GetAddress(), size_);
+        if constexpr (IsTriviallyRelocatable<T>::value) {
+            if (TryReallocate(new_capacity)) {
+                return;
+            }
+        }
+        RawMemory<T, Allocator> new_data(new_capacity, GetAllocator());
+        RelocateN(data_.GetAddress(), size_, new_data.GetAddress());
+        AdoptBuffer(new_data);
+    }
 
-        data_.Swap(new_data);
+    // Как Reserve, но при нехватке памяти возвращает false и оставляет вектор без изменений
+    bool TryReserve(size_t new_capacity) {
+        if (new_capacity <= data_.Capacity()) {
+            return true;
+        }
+        if (new_capacity > MaxSize()) {
+            return false;
+        }
+        const AnnotationScope scope(*this, size_);
+        if (TryExpand(new_capacity)) {
+            return true;
+        }
+        RawMemory<T, Allocator> new_data(GetAllocator());
+        if (!new_data.TryAllocate(new_capacity)) {
+            return false;
+        }
+        RelocateN(data_.GetAddress(), size_, new_data.GetAddress());
+        AdoptBuffer(new_data);
+        return true;
+    }
+
+    // Уменьшает вместимость до max(new_capacity, Size()). Пустой вектор освобождает память целиком,
+    // а вектор со встроенным буфером возвращает в него элементы, если они там помещаются
+    void ShrinkTo(size_t new_capacity) {
+        new_capacity = std::max(new_capacity, size_);
+        if (new_capacity >= Capacity()) {
+            return;
+        }
+        if constexpr (HAS_INLINE_BUFFER) {
+            if (data_.IsInline()) {
+                return;
+            }
+        }
+        const AnnotationScope scope(*this, size_);
+        if (new_capacity <= Storage::INLINE_CAPACITY) {
+            Stats::OnReallocate(Capacity(), Storage::INLINE_CAPACITY);
+            ReleaseBuffer();
+            RawMemory<T, Allocator> old_data(GetAllocator());
+            data_.Swap(old_data);
+            if constexpr (HAS_INLINE_BUFFER) {
+                VECTOR_TRY {
+                    RelocateN(old_data.GetAddress(), size_, data_.GetAddress());
+                } VECTOR_CATCH_ALL {
+                    data_.Swap(old_data);
+                    VECTOR_RETHROW;
+                }
+            }
+            return;
+        }
+        if constexpr (IsTriviallyRelocatable<T>::value) {
+            // Аллокатор может сжать блок на месте или вернуть хвостовые страницы системе
+            if (TryReallocate(new_capacity)) {
+                return;
+            }
+        }
+        RawMemory<T, Allocator> new_data(new_capacity, GetAllocator());
+        RelocateN(data_.GetAddress(), size_, new_data.GetAddress());
+        AdoptBuffer(new_data);
+    }
+
+    void ShrinkToFit() {
+        ShrinkTo(size_);
     }
 
     size_t Size() const noexcept {
@@ -217,8 +1069,69 @@ public:
         return data_.Capacity();
     }
 
+    // Адрес первого элемента. У вектора без памяти равен nullptr
+    T* Data() noexcept {
+        return data_.GetAddress();
+    }
+
+    const T* Data() const noexcept {
+        return data_.GetAddress();
+    }
+
+    size_t MaxSize() const noexcept {
+        return AllocTraits::max_size(GetAllocator());
+    }
+
+    // Для совместимости с std::data, std::size и конструктором std::span из диапазона
+    T* data() noexcept {
+        return data_.GetAddress();
+    }
+    const T* data() const noexcept {
+        return data_.GetAddress();
+    }
+    size_t size() const noexcept {
+        return size_;
+    }
+
+    // Принимает во владение буфер ptr из capacity ячеек, в начале которого созданы size элементов,
+    // например заполненный чтением из сокета. Буфер должен быть выделен аллокатором, равным
+    // GetAllocator(): им же он будет освобождён. Прежние элементы уничтожаются, а память освобождается
+    void Adopt(T* ptr, size_t size, size_t capacity) noexcept {
+        assert(size <= capacity && (ptr != nullptr || capacity == 0));
+        const AnnotationScope scope(*this, 0);
+        Clear();
+        ReleaseBuffer();
+        RawMemory<T, Allocator> buffer(ptr, capacity, GetAllocator());
+        data_.Swap(buffer);
+        size_ = size;
+    }
+
+    // Отдаёт буфер с элементами, оставляя вектор пустым. Вызывающий код отвечает за уничтожение
+    // элементов и освобождение блока аллокатором, равным GetAllocator(). Элементы из встроенного
+    // буфера предварительно переносятся в кучу
+    ReleasedBuffer<T> Release() noexcept(!HAS_INLINE_BUFFER) {
+        ReleaseBuffer();
+        RawMemory<T, Allocator> released(GetAllocator());
+        if constexpr (HAS_INLINE_BUFFER) {
+            if (data_.IsInline()) {
+                if (size_ == 0) {
+                    return {};
+                }
+                RawMemory<T, Allocator> new_data(size_, GetAllocator());
+                RelocateN(data_.GetAddress(), size_, new_data.GetAddress());
+                new_data.Swap(released);
+            } else {
+                data_.Swap(released);
+            }
+        } else {
+            data_.Swap(released);
+        }
+        const size_t capacity = released.Capacity();
+        return {released.Release(), std::exchange(size_, 0), capacity};
+    }
+
     const T& operator[](size_t index) const noexcept {
-        return const_cast<Vector&>(*this)[index];
+        return const_cast<BasicVector&>(*this)[index];
     }
 
     T& operator[](size_t index) noexcept {
@@ -230,6 +1143,7 @@ public:
         if (new_size == size_) {
             return;
         }
+        const AnnotationScope scope(*this, new_size);
         if (new_size < size_) {
             std::destroy_n(data_.GetAddress() + new_size, (size_ - new_size));            
         } else {
@@ -239,28 +1153,173 @@ public:
         size_ = new_size;
     }
 
+    // Аналог Resize, создающий новые и уничтожающий лишние элементы параллельно
+    void Resize(size_t new_size, ParallelPolicy policy) {
+        if (new_size <= size_) {
+            DestroyTail(new_size, policy);
+            return;
+        }
+        const AnnotationScope scope(*this, new_size);
+        Reserve(new_size);
+        T* data = data_.GetAddress() + size_;
+        detail::ParallelFor(policy, new_size - size_,
+            [data](size_t first, size_t last) {
+                std::uninitialized_value_construct_n(data + first, last - first);
+            },
+            [data](size_t first, size_t last) noexcept {
+                std::destroy_n(data + first, last - first);
+            });
+        size_ = new_size;
+    }
+
+    void Clear() noexcept {
+        const AnnotationScope scope(*this, size_);
+        std::destroy_n(data_.GetAddress(), size_);
+        size_ = 0;
+    }
+
+    // Уничтожает элементы параллельно. Деструктор вектора работает в одном потоке,
+    // поэтому большой вектор с нетривиальными элементами стоит очистить так перед уничтожением
+    void Clear(ParallelPolicy policy) noexcept {
+        DestroyTail(0, policy);
+    }
+
+    // Аналог Resize, создающий новые элементы инициализацией по умолчанию
+    void ResizeDefaultInit(size_t new_size) {
+        if (new_size <= size_) {
+            Resize(new_size);
+            return;
+        }
+        const AnnotationScope scope(*this, new_size);
+        Reserve(new_size);
+        std::uninitialized_default_construct_n(data_.GetAddress() + size_, new_size - size_);
+        size_ = new_size;
+    }
+
+    // Увеличивает размер до new_size, создавая новые элементы инициализацией по умолчанию, и передаёт
+    // их на заполнение операции op(T* data, size_t new_size). Операция возвращает число элементов r <= new_size,
+    // которые следует оставить в векторе, остальные удаляются. Если op выбрасывает исключение,
+    // размер вектора восстанавливается
+    template <typename Operation>
+    void ResizeAndOverwrite(size_t new_size, Operation op) {
+        const AnnotationScope scope(*this, new_size);
+        const size_t old_size = size_;
+        ResizeDefaultInit(new_size);
+        size_t result_size;
+        VECTOR_TRY {
+            result_size = static_cast<size_t>(std::move(op)(data_.GetAddress(), new_size));
+        } VECTOR_CATCH_ALL {
+            if (new_size > old_size) {
+                Resize(old_size);
+            }
+            VECTOR_RETHROW;
+        }
+        assert(result_size <= new_size);
+        Resize(result_size);
+    }
+
     void PushBack(const T& value) {
-        EmplaceShared(end(), value);
+        EmplaceBack(value);
     }
 
     void PushBack(T&& value) {
-        EmplaceShared(end(), std::forward<T>(value));
+        EmplaceBack(std::move(value));
+    }
+
+    // Добавляет элемент, сообщая о нехватке памяти результатом вместо исключения.
+    // Исключения конструктора T по-прежнему выходят наружу
+    bool TryPushBack(const T& value) {
+        return TryEmplaceBack(value) != nullptr;
+    }
+
+    bool TryPushBack(T&& value) {
+        return TryEmplaceBack(std::move(value)) != nullptr;
     }
     void PopBack() noexcept {
+        const AnnotationScope scope(*this, size_);
         std::destroy_n(data_.GetAddress() + (size_ - 1), 1);
         --size_;
     }
 
     template <typename... Args>
     T& EmplaceBack(Args&&... args) {
+        const AnnotationScope scope(*this, size_ + 1);
+        if (size_ < Capacity()) {
+            T* result = new (data_.GetAddress() + size_) T(std::forward<Args>(args)...);
+            ++size_;
+            return *result;
+        }
         return *(EmplaceShared(end(), std::forward<Args>(args)...));
     }
 
-    iterator Erase(const_iterator pos) noexcept {
-        pos->~T();
-        std::move(const_cast<iterator>(pos) + 1, end(), const_cast<iterator>(pos));
+    // Возвращает адрес нового элемента или nullptr, если для него не удалось выделить память.
+    // В этом случае вектор не меняется
+    template <typename... Args>
+    T* TryEmplaceBack(Args&&... args) {
+        const AnnotationScope scope(*this, size_ + 1);
+        if (size_ < Capacity()) {
+            T* result = new (data_.GetAddress() + size_) T(std::forward<Args>(args)...);
+            ++size_;
+            return result;
+        }
+        if (size_ == MaxSize()) {
+            return nullptr;
+        }
+        const size_t new_capacity = GrowthPolicy::template NextCapacity<T>(Capacity(), size_ + 1);
+        if (TryExpand(new_capacity)) {
+            return EmplaceWithinCapacity(size_, std::forward<Args>(args)...);
+        }
+        RawMemory<T, Allocator> new_data(GetAllocator());
+        if (!new_data.TryAllocate(new_capacity)) {
+            return nullptr;
+        }
+        return EmplaceWithReallocation(size_, new_data, std::forward<Args>(args)...);
+    }
+
+    iterator Erase(const_iterator pos) noexcept(std::is_nothrow_move_assignable_v<T>) {
+        return Erase(pos, pos + 1);
+    }
+
+    // Удаляет элементы [first, last), сдвигая хвост за один проход
+    iterator Erase(const_iterator first, const_iterator last) noexcept(std::is_nothrow_move_assignable_v<T>) {
+        const size_t offset = first - cbegin();
+        const size_t count = last - first;
+        iterator result = begin() + offset;
+        if (count == 0) {
+            return result;
+        }
+        const AnnotationScope scope(*this, size_);
+        assert(offset + count <= size_);
+        if constexpr (IsTriviallyRelocatable<T>::value) {
+            std::destroy_n(result, count);
+            std::memmove(static_cast<void*>(result), static_cast<const void*>(result + count),
+                         (size_ - offset - count) * sizeof(T));
+        } else {
+            iterator new_end = std::move(result + count, end(), result);
+            std::destroy(new_end, end());
+        }
+        size_ -= count;
+        return result;
+    }
+
+    // Удаляет элемент за O(1), перенося на его место последний элемент. Порядок элементов не сохраняется
+    iterator SwapErase(const_iterator pos) noexcept(std::is_nothrow_move_assignable_v<T>) {
+        const AnnotationScope scope(*this, size_);
+        iterator result = begin() + (pos - cbegin());
+        iterator last = end() - 1;
+        if constexpr (IsTriviallyRelocatable<T>::value) {
+            result->~T();
+            if (result != last) {
+                std::memcpy(static_cast<void*>(result), static_cast<const void*>(last), sizeof(T));
+            }
+        } else {
+            if (result != last) {
+                *result = std::move(*last);
+            }
+            last->~T();
+        }
         --size_;
-        return begin() + std::distance(cbegin(), pos);
+        return result;
     }
 
     template <typename... Args>
@@ -275,56 +1334,485 @@ public:
         return EmplaceShared(pos, std::forward<T>(value));
     }
 
+    // Вставляет count копий value, выполняя не более одной реаллокации
+    iterator Insert(const_iterator pos, size_t count, const T& value) {
+        // value может ссылаться на элемент самого вектора
+        const T value_copy(value);
+        return InsertRange(pos, detail::RepeatIterator<T>(value_copy), count);
+    }
+
+    // Вставляет элементы диапазона [first, last), который не должен ссылаться на элементы
+    // самого вектора. Для однопроходных итераторов элементы добавляются в конец и затем
+    // переставляются на место вставки
+    template <typename InputIt, typename = detail::RequireInputIterator<InputIt>>
+    iterator Insert(const_iterator pos, InputIt first, InputIt last) {
+        if constexpr (detail::IS_ITERATOR_OF_CATEGORY<InputIt, std::forward_iterator_tag>) {
+            return InsertRange(pos, first, static_cast<size_t>(std::distance(first, last)));
+        } else {
+            const size_t offset = pos - cbegin();
+            const size_t old_size = size_;
+            for (; first != last; ++first) {
+                EmplaceBack(*first);
+            }
+            std::rotate(begin() + offset, begin() + old_size, end());
+            return begin() + offset;
+        }
+    }
+
+    iterator Insert(const_iterator pos, std::initializer_list<T> values) {
+        return InsertRange(pos, values.begin(), values.size());
+    }
+
+    template <typename InputIt, typename = detail::RequireInputIterator<InputIt>>
+    void Append(InputIt first, InputIt last) {
+        Insert(cend(), first, last);
+    }
+
+    template <typename Range>
+    void Append(const Range& range) {
+        Insert(cend(), std::begin(range), std::end(range));
+    }
+
+    void Append(std::initializer_list<T> values) {
+        InsertRange(cend(), values.begin(), values.size());
+    }
+
+#if VECTOR_DEBUG
+    // Число смен буфера. Итераторы, полученные до смены, недействительны. В отличие от стандартных
+    // контейнеров, перемещение и обмен векторов тоже делают недействительными их итераторы
+    size_t GetGeneration() const noexcept {
+        return generation_;
+    }
+#endif
+
 private:
-    RawMemory<T> data_;
+    // Размер разметки, означающий, что весь буфер доступен
+    static constexpr size_t NOT_ANNOTATED = SIZE_MAX;
+
+    Storage data_;
     size_t size_ = 0;
+#if VECTOR_DEBUG
+    size_t generation_ = 0;
+#endif
+#if VECTOR_ANNOTATE_CONTAINER
+    // Ячейки буфера, начиная с annotated_size_, помечены для AddressSanitizer недоступными
+    size_t annotated_size_ = NOT_ANNOTATED;
+    // Глубина вложенности изменяющих операций
+    size_t annotation_depth_ = 0;
+#endif
 
-    template <typename... Args>
-    iterator EmplaceShared(const_iterator pos, Args&&... args) {
-        iterator result;
-        if (size_ == Capacity()) {
-            RawMemory<T> new_data(size_ == 0 ? 1 : size_ * 2);
-            result = new (new_data.GetAddress() + std::distance(cbegin(), pos)) T(std::forward<Args>(args)...);
-            try {
-                if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-                    std::uninitialized_move_n(begin(), std::distance(cbegin(), pos), new_data.GetAddress());
-                } else {
-                    std::uninitialized_copy_n(cbegin(), std::distance(cbegin(), pos), new_data.GetAddress());
+    // На время изменяющей операции открывает доступ к ячейкам вплоть до required_size, в которые
+    // она может писать, а по завершении внешней операции, в том числе по исключению, закрывает
+    // доступ к ячейкам за последним элементом. Без разметки ничего не делает
+    class AnnotationScope {
+    public:
+#if VECTOR_ANNOTATE_CONTAINER
+        AnnotationScope(BasicVector& vector, size_t required_size) noexcept
+            : vector_(vector) {
+            if (required_size > vector_.annotated_size_) {
+                vector_.AnnotateFrom(required_size);
+            }
+            ++vector_.annotation_depth_;
+        }
+
+        AnnotationScope(const AnnotationScope&) = delete;
+        AnnotationScope& operator=(const AnnotationScope&) = delete;
+
+        ~AnnotationScope() {
+            if (--vector_.annotation_depth_ == 0) {
+                vector_.AnnotateFrom(vector_.size_);
+            }
+        }
+
+    private:
+        BasicVector& vector_;
+#else
+        AnnotationScope(BasicVector&, size_t) noexcept {
+        }
+#endif
+    };
+
+    // Помечает ячейки буфера до mid доступными, а начиная с mid — недоступными. Размечается только буфер
+    // в куче с началом, выровненным по 8 байт, без последнего неполного восьмибайтового блока: он может
+    // принадлежать соседнему объекту, например в буфере std::pmr::monotonic_buffer_resource
+    void AnnotateFrom([[maybe_unused]] size_t mid) noexcept {
+#if VECTOR_ANNOTATE_CONTAINER
+        bool is_annotatable = Capacity() != 0;
+        if constexpr (HAS_INLINE_BUFFER) {
+            is_annotatable = is_annotatable && !data_.IsInline();
+        }
+        const char* first = reinterpret_cast<const char*>(data_.GetAddress());
+        const char* last = first + Capacity() * sizeof(T) / 8 * 8;
+        if (is_annotatable && reinterpret_cast<uintptr_t>(first) % 8 == 0 && first != last) {
+            const auto address = [this, first, last](size_t count) {
+                return std::min(first + std::min(count, Capacity()) * sizeof(T), last);
+            };
+            __sanitizer_annotate_contiguous_container(first, last, address(annotated_size_), address(mid));
+        }
+        annotated_size_ = mid;
+#endif
+    }
+
+    // Снимает разметку и делает итераторы недействительными перед тем, как буфер покинет вектор
+    void ReleaseBuffer() noexcept {
+        AnnotateFrom(NOT_ANNOTATED);
+        InvalidateIterators();
+    }
+
+    // Вызывается после того, как буфер other вместе с его разметкой перешёл к *this
+    void TakeAnnotation([[maybe_unused]] BasicVector& other) noexcept {
+#if VECTOR_ANNOTATE_CONTAINER
+        annotated_size_ = std::exchange(other.annotated_size_, NOT_ANNOTATED);
+#endif
+        other.InvalidateIterators();
+    }
+
+    void InvalidateIterators() noexcept {
+#if VECTOR_DEBUG
+        ++generation_;
+#endif
+    }
+
+    iterator MakeIterator(T* ptr) noexcept {
+#if VECTOR_DEBUG
+        return iterator(ptr, this);
+#else
+        return ptr;
+#endif
+    }
+
+    const_iterator MakeIterator(const T* ptr) const noexcept {
+#if VECTOR_DEBUG
+        return const_iterator(ptr, this);
+#else
+        return ptr;
+#endif
+    }
+
+    // Проверяет, может ли *this забрать буфер other целиком, не перемещая элементы
+    bool CanStealBuffer(const BasicVector& other) const noexcept {
+        if constexpr (HAS_INLINE_BUFFER) {
+            if (other.data_.IsInline()) {
+                return false;
+            }
+        }
+        if constexpr (!AllocTraits::is_always_equal::value) {
+            return GetAllocator() == other.GetAllocator();
+        }
+        return true;
+    }
+
+    // Параллельно уничтожает элементы, начиная с new_size. Если ParallelFor не смог выделить
+    // память под служебные данные, элементы уничтожаются в текущем потоке
+    void DestroyTail(size_t new_size, const ParallelPolicy& policy) noexcept {
+        const AnnotationScope scope(*this, size_);
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            T* data = data_.GetAddress() + new_size;
+            const auto destroy = [data](size_t first, size_t last) noexcept {
+                std::destroy_n(data + first, last - first);
+            };
+            VECTOR_TRY {
+                detail::ParallelFor(policy, size_ - new_size, destroy, destroy);
+            } VECTOR_CATCH_ALL {
+                // Исключение возможно только до начала уничтожения
+                destroy(0, size_ - new_size);
+            }
+        }
+        size_ = new_size;
+    }
+
+    // Итераторы, диапазоны которых можно копировать побайтово
+    template <typename It>
+    static constexpr bool IS_BITWISE_COPYABLE = std::is_trivially_copyable_v<T>
+        && (std::is_same_v<It, T*> || std::is_same_v<It, const T*>);
+
+    // Копирующее присваивание n элементов, начиная с first, живым элементам по адресу to.
+    // Диапазоны не должны перекрываться
+    template <typename ForwardIt>
+    static void CopyN(ForwardIt first, size_t n, T* to) {
+        if constexpr (IS_BITWISE_COPYABLE<ForwardIt>) {
+            if (n != 0) {
+                std::memcpy(static_cast<void*>(to), static_cast<const void*>(first), n * sizeof(T));
+            }
+        } else {
+            std::copy_n(first, n, to);
+        }
+    }
+
+    static void CopyN(detail::RepeatIterator<T> first, size_t n, T* to) {
+        std::fill_n(to, n, *first);
+    }
+
+    // Копирует n элементов, начиная с first, в неинициализированную память to
+    template <typename ForwardIt>
+    static void UninitializedCopyN(ForwardIt first, size_t n, T* to) {
+        if constexpr (IS_BITWISE_COPYABLE<ForwardIt>) {
+            if (n != 0) {
+                std::memcpy(static_cast<void*>(to), static_cast<const void*>(first), n * sizeof(T));
+            }
+        } else {
+            std::uninitialized_copy_n(first, n, to);
+        }
+    }
+
+    static void UninitializedCopyN(detail::RepeatIterator<T> first, size_t n, T* to) {
+        std::uninitialized_fill_n(to, n, *first);
+    }
+
+    // Заменяет содержимое count элементами, начиная с first. Живые элементы переиспользуются
+    // через присваивание, а новая память выделяется, только если не хватает вместимости
+    template <typename ForwardIt>
+    void AssignRange(ForwardIt first, size_t count) {
+        const AnnotationScope scope(*this, count);
+        if (count > Capacity()) {
+            RawMemory<T, Allocator> new_data(count, GetAllocator());
+            UninitializedCopyN(first, count, new_data.GetAddress());
+            std::destroy_n(data_.GetAddress(), size_);
+            size_ = 0;
+            AdoptBuffer(new_data);
+        } else if (count <= size_) {
+            CopyN(first, count, data_.GetAddress());
+            std::destroy_n(data_.GetAddress() + count, size_ - count);
+        } else {
+            CopyN(first, size_, data_.GetAddress());
+            UninitializedCopyN(std::next(first, size_), count - size_, data_.GetAddress() + size_);
+        }
+        size_ = count;
+    }
+
+    // Переносит n элементов из from в неинициализированную память to, после чего элементы
+    // по адресу from считаются уничтоженными. Тривиально перемещаемые типы переносятся
+    // одним memcpy без вызова деструкторов
+    static void RelocateN(T* from, size_t n, T* to) {
+        if constexpr (IsTriviallyRelocatable<T>::value) {
+            Stats::OnRelocate(n * sizeof(T));
+            if (n != 0) {
+                std::memcpy(static_cast<void*>(to), static_cast<const void*>(from), n * sizeof(T));
+            }
+        } else {
+            UninitializedMoveOrCopyN(from, n, to);
+            std::destroy_n(from, n);
+        }
+    }
+
+    // Перемещает n элементов в неинициализированную память, если перемещение не бросает исключений
+    // (или копирование невозможно), иначе копирует их, сохраняя исходные элементы нетронутыми
+    static void UninitializedMoveOrCopyN(T* from, size_t n, T* to) {
+        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+            std::uninitialized_move_n(from, n, to);
+            Stats::OnRelocate(n * sizeof(T));
+        } else {
+            std::uninitialized_copy_n(from, n, to);
+            Stats::OnCopyFallback(n * sizeof(T));
+        }
+    }
+
+    // Пытается расширить буфер на месте, не перемещая элементы
+    bool TryExpand(size_t new_capacity) noexcept {
+        const size_t old_capacity = Capacity();
+        if constexpr (Storage::CAN_EXPAND) {
+            // Разметка рассчитана на прежнюю вместимость
+            AnnotateFrom(NOT_ANNOTATED);
+        }
+        if (!data_.TryExpand(new_capacity)) {
+            return false;
+        }
+        Stats::OnExpand(old_capacity, Capacity());
+        return true;
+    }
+
+    // Пытается перенести буфер вместе с элементами средствами аллокатора
+    bool TryReallocate(size_t new_capacity) {
+        const size_t old_capacity = Capacity();
+        const T* old_address = data_.GetAddress();
+        if constexpr (Storage::CAN_REALLOCATE) {
+            AnnotateFrom(NOT_ANNOTATED);
+        }
+        if (!data_.TryReallocate(new_capacity)) {
+            return false;
+        }
+        if (data_.GetAddress() != old_address) {
+            InvalidateIterators();
+        }
+        Stats::OnReallocate(old_capacity, Capacity());
+        Stats::OnRelocate(size_ * sizeof(T));
+        return true;
+    }
+
+    // Заменяет текущий буфер буфером new_data, в который уже перенесены элементы
+    void AdoptBuffer(RawMemory<T, Allocator>& new_data) noexcept {
+        Stats::OnReallocate(Capacity(), new_data.Capacity());
+        ReleaseBuffer();
+        data_.Swap(new_data);
+    }
+
+    // Вставляет count элементов, начиная с first, перед pos. Новая вместимость вычисляется один раз,
+    // а хвост вектора сдвигается за один проход
+    template <typename ForwardIt>
+    iterator InsertRange(const_iterator pos, ForwardIt first, size_t count) {
+        const size_t offset = pos - cbegin();
+        if (count == 0) {
+            return begin() + offset;
+        }
+        const AnnotationScope scope(*this, size_ + count);
+        const size_t tail = size_ - offset;
+        const size_t new_capacity = GrowthPolicy::template NextCapacity<T>(Capacity(), size_ + count);
+        if (size_ + count > Capacity() && !TryExpand(new_capacity)) {
+            RawMemory<T, Allocator> new_data(new_capacity, GetAllocator());
+            T* inserted = new_data.GetAddress() + offset;
+            UninitializedCopyN(first, count, inserted);
+            if constexpr (IS_NOTHROW_RELOCATABLE) {
+                RelocateN(data_.GetAddress(), offset, new_data.GetAddress());
+                RelocateN(data_.GetAddress() + offset, tail, inserted + count);
+            } else {
+                VECTOR_TRY {
+                    UninitializedMoveOrCopyN(data_.GetAddress(), offset, new_data.GetAddress());
+                } VECTOR_CATCH_ALL {
+                    std::destroy_n(inserted, count);
+                    VECTOR_RETHROW;
                 }
-            } catch (...) {
-                result->~T();
-                throw;
+                VECTOR_TRY {
+                    UninitializedMoveOrCopyN(data_.GetAddress() + offset, tail, inserted + count);
+                } VECTOR_CATCH_ALL {
+                    std::destroy_n(new_data.GetAddress(), offset);
+                    std::destroy_n(inserted, count);
+                    VECTOR_RETHROW;
+                }
+                std::destroy_n(data_.GetAddress(), size_);
+            }
+            AdoptBuffer(new_data);
+            size_ += count;
+        } else if constexpr (IsTriviallyRelocatable<T>::value) {
+            // Хвост сдвигается побайтово, а при исключении возвращается на место
+            T* hole = data_.GetAddress() + offset;
+            if (tail != 0) {
+                std::memmove(static_cast<void*>(hole + count), static_cast<const void*>(hole), tail * sizeof(T));
             }
-            try {
-                if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-                    std::uninitialized_move_n(const_cast<iterator>(pos), std::distance(pos, cend()), new_data.GetAddress() + std::distance(cbegin(), pos) + 1);
-                } else {
-                    std::uninitialized_copy_n(pos, std::distance(pos, cend()), new_data.GetAddress() + std::distance(cbegin(), pos) + 1);
+            VECTOR_TRY {
+                UninitializedCopyN(first, count, hole);
+            } VECTOR_CATCH_ALL {
+                if (tail != 0) {
+                    std::memmove(static_cast<void*>(hole), static_cast<const void*>(hole + count), tail * sizeof(T));
                 }
-            } catch (...) {
-                std::destroy_n(new_data.GetAddress(), std::distance(cbegin(), pos));
-                result->~T();
-                throw;
+                VECTOR_RETHROW;
             }
-            std::destroy_n(begin(), size_);
-            data_.Swap(new_data);
+            size_ += count;
         } else {
-            if (pos == cend()) {
-                result = new (data_.GetAddress() + size_) T(std::forward<Args>(args)...);
+            T* hole = data_.GetAddress() + offset;
+            T* old_end = data_.GetAddress() + size_;
+            if (tail > count) {
+                std::uninitialized_move(old_end - count, old_end, old_end);
+                size_ += count;
+                std::move_backward(hole, old_end - count, old_end);
+                CopyN(first, count, hole);
             } else {
-                result = const_cast<iterator>(pos);
+                // Часть новых элементов попадает в неинициализированную память за концом вектора
+                ForwardIt mid = std::next(first, tail);
+                UninitializedCopyN(mid, count - tail, old_end);
+                size_ += count - tail;
+                std::uninitialized_move(hole, old_end, hole + count);
+                size_ += tail;
+                CopyN(first, tail, hole);
+            }
+        }
+        return begin() + offset;
+    }
+
+    template <typename... Args>
+    iterator EmplaceShared(const_iterator pos, Args&&... args) {
+        const size_t offset = pos - cbegin();
+        const AnnotationScope scope(*this, size_ + 1);
+        if (size_ == Capacity()) {
+            if (size_ == MaxSize()) {
+                VECTOR_THROW(std::length_error("Vector is too long"));
+            }
+            const size_t new_capacity = GrowthPolicy::template NextCapacity<T>(Capacity(), size_ + 1);
+            if constexpr (IsTriviallyRelocatable<T>::value && Storage::CAN_REALLOCATE) {
+                // Аргументы могут ссылаться на элементы, которые reallocate перенесёт в другой блок
                 T temp(std::forward<Args>(args)...);
-                if (size_ > 0) {
-                    new (end()) T(std::move(*(end() - 1)));
-                    if (size_ > 1) {
-                        std::move_backward(result, end() - 1, end());
-                    }
+                if (TryExpand(new_capacity) || TryReallocate(new_capacity)) {
+                    return EmplaceWithinCapacity(offset, std::move(temp));
+                }
+                RawMemory<T, Allocator> new_data(new_capacity, GetAllocator());
+                return EmplaceWithReallocation(offset, new_data, std::move(temp));
+            } else {
+                if (!TryExpand(new_capacity)) {
+                    RawMemory<T, Allocator> new_data(new_capacity, GetAllocator());
+                    return EmplaceWithReallocation(offset, new_data, std::forward<Args>(args)...);
                 }
-                *result = std::move(temp);
-            }          
+            }
         }
+        return EmplaceWithinCapacity(offset, std::forward<Args>(args)...);
+    }
+
+    // Создаёт элемент в позиции offset уже выделенного буфера new_data и переносит туда остальные
+    template <typename... Args>
+    iterator EmplaceWithReallocation(size_t offset, RawMemory<T, Allocator>& new_data, Args&&... args) {
+        assert(offset <= size_ && size_ < new_data.Capacity());
+        T* result = new (new_data.GetAddress() + offset) T(std::forward<Args>(args)...);
+        if constexpr (IS_NOTHROW_RELOCATABLE) {
+            RelocateN(data_.GetAddress(), offset, new_data.GetAddress());
+            if (offset < size_) {
+                RelocateN(data_.GetAddress() + offset, size_ - offset, new_data.GetAddress() + offset + 1);
+            }
+        } else {
+            VECTOR_TRY {
+                UninitializedMoveOrCopyN(data_.GetAddress(), offset, new_data.GetAddress());
+            } VECTOR_CATCH_ALL {
+                result->~T();
+                VECTOR_RETHROW;
+            }
+            VECTOR_TRY {
+                UninitializedMoveOrCopyN(data_.GetAddress() + offset, size_ - offset, new_data.GetAddress() + offset + 1);
+            } VECTOR_CATCH_ALL {
+                std::destroy_n(new_data.GetAddress(), offset);
+                result->~T();
+                VECTOR_RETHROW;
+            }
+            std::destroy_n(data_.GetAddress(), size_);
+        }
+        AdoptBuffer(new_data);
         ++size_;
-        return result;
+        return MakeIterator(result);
+    }
+
+    template <typename... Args>
+    iterator EmplaceWithinCapacity(size_t offset, Args&&... args) {
+        if (offset < size_) {
+            T* result = data_.GetAddress() + offset;
+            T* last = result + (size_ - 1 - offset);
+            T temp(std::forward<Args>(args)...);
+            new (last + 1) T(std::move(*last));
+            // Новый последний элемент учитывается сразу, чтобы исключение при сдвиге не оставило его неуничтоженным
+            ++size_;
+            std::move_backward(result, last, last + 1);
+            *result = std::move(temp);
+            return MakeIterator(result);
+        }
+        T* result = new (data_.GetAddress() + size_) T(std::forward<Args>(args)...);
+        ++size_;
+        return MakeIterator(result);
     }
 };
 
+template <typename T, typename Allocator = std::allocator<T>, typename GrowthPolicy = DoublingGrowth,
+          typename Stats = NoStats>
+using Vector = BasicVector<T, RawMemory<T, Allocator>, GrowthPolicy, Stats>;
+
+// Удаляет элементы, удовлетворяющие предикату pred, сохраняя порядок остальных.
+// Возвращает число удалённых элементов
+template <typename T, typename Storage, typename GrowthPolicy, typename Stats, typename Predicate>
+size_t EraseIf(BasicVector<T, Storage, GrowthPolicy, Stats>& vector, Predicate pred) {
+    auto new_end = std::remove_if(vector.begin(), vector.end(), pred);
+    const size_t count = vector.end() - new_end;
+    vector.Erase(new_end, vector.end());
+    return count;
+}
+
+namespace pmr {
+
+// Вектор, получающий память из std::pmr::memory_resource
+template <typename T, typename GrowthPolicy = DoublingGrowth, typename Stats = NoStats>
+using Vector = ::Vector<T, std::pmr::polymorphic_allocator<T>, GrowthPolicy, Stats>;
+
+}  // namespace pmr
\ No newline at end of file
@@ -0,0 +1,337 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+// Параллельные алгоритмы над контейнерами с непрерывным хранением (Vector, StaticVector, MappedVector...).
+// Контейнер делится на части так же, как в ParallelFor: не меньше policy.min_chunk_size элементов
+// на поток, поэтому небольшие контейнеры обрабатываются в вызывающем потоке без накладных расходов.
+// Внутренние циклы Transform, Reduce и FindIf собираются в двух вариантах: для базовой архитектуры
+// и с target("avx2") на x86, а вариант выбирается во время выполнения по __builtin_cpu_supports.
+// На AArch64 NEON входит в базовую архитектуру, поэтому там используется единственный вариант
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && !defined(__AVX2__)
+#define VECTOR_AVX2_DISPATCH 1
+#else
+#define VECTOR_AVX2_DISPATCH 0
+#endif
+
+namespace detail {
+
+// Ширина векторного регистра, под которую подбираются развёртки циклов
+inline constexpr size_t SIMD_BYTES = 32;
+
+// Ядра — функциональные объекты с always_inline, чтобы их тело компилировалось заново
+// внутри InvokeAvx2 с набором инструкций AVX2
+#if defined(__GNUC__)
+#define VECTOR_KERNEL_INLINE __attribute__((always_inline)) inline
+#else
+#define VECTOR_KERNEL_INLINE inline
+#endif
+
+#if VECTOR_AVX2_DISPATCH
+
+inline bool HasAvx2() noexcept {
+    static const bool result = [] {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+    }();
+    return result;
+}
+
+template <typename Kernel, typename... Args>
+__attribute__((target("avx2"))) decltype(auto) InvokeAvx2(const Kernel& kernel, Args&&... args) {
+    return kernel(std::forward<Args>(args)...);
+}
+
+#endif
+
+// Вызывает kernel в варианте для лучшего набора инструкций, который поддерживает процессор
+template <typename Kernel, typename... Args>
+decltype(auto) InvokeSimd(const Kernel& kernel, Args&&... args) {
+#if VECTOR_AVX2_DISPATCH
+    if (HasAvx2()) {
+        return InvokeAvx2(kernel, std::forward<Args>(args)...);
+    }
+#endif
+    return kernel(std::forward<Args>(args)...);
+}
+
+// Сумма [first, last) в нескольких независимых аккумуляторах, которые компилятор размещает
+// в одном векторном регистре
+struct SumKernel {
+    template <typename T>
+    VECTOR_KERNEL_INLINE T operator()(const T* data, size_t first, size_t last) const noexcept {
+        constexpr size_t LANES = std::max<size_t>(1, SIMD_BYTES / sizeof(T));
+        T lanes[LANES] = {};
+        for (; first + LANES <= last; first += LANES) {
+            for (size_t lane = 0; lane != LANES; ++lane) {
+                lanes[lane] += data[first + lane];
+            }
+        }
+        T result = T();
+        for (const T lane : lanes) {
+            result += lane;
+        }
+        for (; first != last; ++first) {
+            result += data[first];
+        }
+        return result;
+    }
+};
+
+struct TransformKernel {
+    template <typename Source, typename T, typename UnaryOp>
+    VECTOR_KERNEL_INLINE void operator()(const Source* source, T* destination, size_t first, size_t last,
+                                         UnaryOp& op) const {
+        for (size_t i = first; i != last; ++i) {
+            destination[i] = op(source[i]);
+        }
+    }
+};
+
+// Проверяет pred для всех элементов блока без ветвлений
+struct AnyOfKernel {
+    template <typename T, typename Predicate>
+    VECTOR_KERNEL_INLINE bool operator()(const T* data, size_t first, size_t last, Predicate& pred) const {
+        bool any = false;
+        for (size_t i = first; i != last; ++i) {
+            any |= static_cast<bool>(pred(data[i]));
+        }
+        return any;
+    }
+};
+
+// Вызывает op(index) для каждого index из [0, count), по потоку на индекс
+template <typename Operation>
+void ParallelForEachIndex(size_t count, Operation op) {
+    ParallelFor(ParallelPolicy{count, 1}, count, [&op](size_t first, size_t last) {
+        for (; first != last; ++first) {
+            op(first);
+        }
+    }, [](size_t, size_t) {});
+}
+
+template <typename T>
+inline constexpr bool IS_RADIX_SORTABLE = std::is_arithmetic_v<T> && !std::is_same_v<T, bool>;
+
+template <typename Compare, typename T>
+inline constexpr bool IS_LESS = std::is_same_v<Compare, std::less<>> || std::is_same_v<Compare, std::less<T>>;
+
+// Беззнаковый ключ, порядок которого совпадает с порядком значений. У отрицательных чисел
+// с плавающей точкой инвертируются все биты, у остальных чисел — только знаковый
+template <typename T>
+auto GetRadixKey(T value) noexcept {
+    using Key = std::conditional_t<sizeof(T) == 1, uint8_t,
+                std::conditional_t<sizeof(T) == 2, uint16_t,
+                std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>>>;
+    static_assert(sizeof(Key) == sizeof(T), "Unsupported arithmetic type");
+    constexpr Key SIGN_BIT = Key{1} << (sizeof(Key) * CHAR_BIT - 1);
+    Key key;
+    std::memcpy(&key, &value, sizeof(T));
+    if constexpr (std::is_floating_point_v<T>) {
+        return static_cast<Key>((key & SIGN_BIT) != 0 ? ~key : key | SIGN_BIT);
+    } else if constexpr (std::is_signed_v<T>) {
+        return static_cast<Key>(key ^ SIGN_BIT);
+    } else {
+        return key;
+    }
+}
+
+// Поразрядная сортировка по байтам от младшего к старшему. scratch вмещает count элементов.
+// Проход пропускается, если у всех элементов одинаковый байт
+template <typename T>
+void RadixSort(T* data, T* scratch, size_t count) {
+    T* from = data;
+    T* to = scratch;
+    for (size_t shift = 0; shift != sizeof(T) * CHAR_BIT; shift += CHAR_BIT) {
+        size_t offsets[256] = {};
+        for (size_t i = 0; i != count; ++i) {
+            ++offsets[(GetRadixKey(from[i]) >> shift) & 0xFF];
+        }
+        if (offsets[(GetRadixKey(from[0]) >> shift) & 0xFF] == count) {
+            continue;
+        }
+        size_t total = 0;
+        for (size_t& offset : offsets) {
+            total += std::exchange(offset, total);
+        }
+        for (size_t i = 0; i != count; ++i) {
+            to[offsets[(GetRadixKey(from[i]) >> shift) & 0xFF]++] = from[i];
+        }
+        std::swap(from, to);
+    }
+    if (from != data) {
+        std::memcpy(data, from, count * sizeof(T));
+    }
+}
+
+// Сортирует часть контейнера. Поразрядная сортировка выгоднее std::sort начиная с нескольких сотен элементов
+template <typename T, typename Compare>
+void SortChunk(T* first, T* last, T* scratch, Compare& comp) {
+    constexpr size_t RADIX_THRESHOLD = 256;
+    if constexpr (IS_RADIX_SORTABLE<T> && IS_LESS<Compare, T>) {
+        if (static_cast<size_t>(last - first) >= RADIX_THRESHOLD) {
+            RadixSort(first, scratch, last - first);
+            return;
+        }
+    }
+    std::sort(first, last, comp);
+}
+
+}  // namespace detail
+
+// Сортирует элементы контейнера. Части сортируются параллельно, затем попарно сливаются
+// за log2(число частей) уровней, пары каждого уровня тоже сливаются параллельно.
+// Арифметические элементы при сравнении по возрастанию сортируются поразрядно.
+// Сортировка неустойчива
+template <typename Container, typename Compare = std::less<>>
+void ParallelSort(Container& container, Compare comp = Compare(), const ParallelPolicy& policy = PARALLEL) {
+    using T = std::remove_reference_t<decltype(*container.Data())>;
+    T* data = container.Data();
+    const size_t count = container.Size();
+    const size_t num_chunks = detail::GetChunkCount(policy, count);
+    const auto chunk_begin = [data, count, num_chunks](size_t chunk) {
+        return data + detail::GetChunkBegin(count, num_chunks, std::min(chunk, num_chunks));
+    };
+    Vector<T> scratch;
+    if constexpr (detail::IS_RADIX_SORTABLE<T> && detail::IS_LESS<Compare, T>) {
+        scratch.ResizeDefaultInit(count);
+    }
+    detail::ParallelForEachIndex(num_chunks, [&](size_t chunk) {
+        T* chunk_scratch = scratch.Size() == 0 ? nullptr : scratch.Data() + (chunk_begin(chunk) - data);
+        detail::SortChunk(chunk_begin(chunk), chunk_begin(chunk + 1), chunk_scratch, comp);
+    });
+    for (size_t width = 1; width < num_chunks; width *= 2) {
+        detail::ParallelForEachIndex((num_chunks + 2 * width - 1) / (2 * width), [&](size_t pair) {
+            const size_t chunk = pair * 2 * width;
+            std::inplace_merge(chunk_begin(chunk), chunk_begin(chunk + width), chunk_begin(chunk + 2 * width), comp);
+        });
+    }
+}
+
+// Поразрядная сортировка арифметических элементов по возрастанию за O(n) с временным буфером
+// из n элементов. Отрицательный ноль предшествует положительному, NaN попадают в начало
+// или в конец в зависимости от знака
+template <typename Container>
+void RadixSort(Container& container) {
+    using T = std::remove_reference_t<decltype(*container.Data())>;
+    static_assert(detail::IS_RADIX_SORTABLE<T>, "RadixSort requires arithmetic elements");
+    if (container.Size() > 1) {
+        Vector<T> scratch(container.Size(), DEFAULT_INIT);
+        detail::RadixSort(container.Data(), scratch.Data(), container.Size());
+    }
+}
+
+// Записывает в output результаты op для каждого элемента input, так что output.Size() == input.Size().
+// Элементы output создаются через ResizeDefaultInit и затем присваиваются, поэтому тривиальные
+// элементы не обнуляются лишний раз. output может совпадать с input. Если op выбрасывает
+// исключение, элементы output остаются в допустимом, но неопределённом состоянии
+template <typename Input, typename T, typename Storage, typename GrowthPolicy, typename Stats, typename UnaryOp>
+void Transform(const Input& input, BasicVector<T, Storage, GrowthPolicy, Stats>& output, UnaryOp op,
+               const ParallelPolicy& policy = PARALLEL) {
+    const size_t count = input.Size();
+    output.ResizeDefaultInit(count);
+    const auto* source = input.Data();
+    T* destination = output.Data();
+    detail::ParallelFor(policy, count, [source, destination, &op](size_t first, size_t last) {
+        using Source = std::remove_cv_t<std::remove_reference_t<decltype(*source)>>;
+        if constexpr (std::is_arithmetic_v<Source> && std::is_arithmetic_v<T>) {
+            detail::InvokeSimd(detail::TransformKernel{}, source, destination, first, last, op);
+        } else {
+            detail::TransformKernel{}(source, destination, first, last, op);
+        }
+    }, [](size_t, size_t) {});
+}
+
+// Сворачивает элементы операцией op, начиная с init. Как и для std::reduce, op должна быть
+// ассоциативной: каждая часть сворачивается начиная со своего первого элемента, приведённого к T,
+// и частичные результаты объединяются с init слева направо. Коммутативность не требуется,
+// и для ассоциативной op результат совпадает с std::accumulate. Если T не создаётся из элемента
+// или по умолчанию, либо op не принимает два T, как у свёртки в аккумулятор, элементы
+// сворачиваются последовательно.
+// Суммы арифметических элементов вычисляются векторным ядром, поэтому суммы чисел с плавающей
+// точкой могут отличаться от последовательной в младших разрядах
+template <typename Container, typename T, typename BinaryOp = std::plus<>>
+T Reduce(const Container& container, T init, BinaryOp op = BinaryOp(), const ParallelPolicy& policy = PARALLEL) {
+    using Element = std::remove_cv_t<std::remove_reference_t<decltype(*container.Data())>>;
+    constexpr bool IS_SUM = std::is_arithmetic_v<T> && std::is_same_v<Element, T>
+                            && (std::is_same_v<BinaryOp, std::plus<>> || std::is_same_v<BinaryOp, std::plus<T>>);
+    constexpr bool CAN_SPLIT = std::is_constructible_v<T, const Element&> && std::is_default_constructible_v<T>
+                               && std::is_invocable_r_v<T, BinaryOp&, T, T>;
+    const Element* data = container.Data();
+    const size_t count = container.Size();
+    const auto reduce_chunk = [data, &op](size_t first, size_t last, T result) {
+        if constexpr (IS_SUM) {
+            return static_cast<T>(result + detail::InvokeSimd(detail::SumKernel{}, data, first, last));
+        } else {
+            for (; first != last; ++first) {
+                result = op(std::move(result), data[first]);
+            }
+            return result;
+        }
+    };
+    const size_t num_chunks = CAN_SPLIT ? detail::GetChunkCount(policy, count) : 1;
+    if (num_chunks <= 1) {
+        return reduce_chunk(0, count, std::move(init));
+    }
+    if constexpr (CAN_SPLIT) {
+        Vector<T> partials(num_chunks, DEFAULT_INIT);
+        detail::ParallelForEachIndex(num_chunks, [&](size_t chunk) {
+            const size_t first = detail::GetChunkBegin(count, num_chunks, chunk);
+            partials[chunk] = reduce_chunk(first + 1, detail::GetChunkBegin(count, num_chunks, chunk + 1),
+                                           T(data[first]));
+        });
+        for (T& partial : partials) {
+            init = op(std::move(init), std::move(partial));
+        }
+    }
+    return init;
+}
+
+// Возвращает указатель на первый элемент, для которого выполняется pred, или end().
+// Арифметические элементы проверяются блоками без ветвлений внутри блока, поэтому pred может
+// вызываться и для нескольких элементов после найденного и не должен иметь побочных эффектов.
+// Потоки прекращают поиск, как только совпадение найдено левее их текущей позиции
+template <typename Container, typename Predicate>
+auto FindIf(Container& container, Predicate pred, const ParallelPolicy& policy = PARALLEL) {
+    using T = std::remove_cv_t<std::remove_reference_t<decltype(*container.Data())>>;
+    constexpr size_t BLOCK_SIZE = std::is_arithmetic_v<T> ? std::max<size_t>(8, detail::SIMD_BYTES / sizeof(T)) : 1;
+    const auto data = container.Data();
+    const size_t count = container.Size();
+    std::atomic<size_t> found{count};
+    const auto store_found = [&found](size_t index) noexcept {
+        size_t current = found.load(std::memory_order_relaxed);
+        while (index < current && !found.compare_exchange_weak(current, index, std::memory_order_relaxed)) {
+        }
+    };
+    detail::ParallelFor(policy, count, [&](size_t first, size_t last) {
+        for (; first != last; first += std::min(BLOCK_SIZE, last - first)) {
+            if (found.load(std::memory_order_relaxed) < first) {
+                return;
+            }
+            const size_t block_end = first + std::min(BLOCK_SIZE, last - first);
+            if constexpr (BLOCK_SIZE > 1) {
+                if (block_end - first == BLOCK_SIZE
+                    && !detail::InvokeSimd(detail::AnyOfKernel{}, data, first, block_end, pred)) {
+                    continue;
+                }
+            }
+            for (size_t i = first; i != block_end; ++i) {
+                if (pred(data[i])) {
+                    store_found(i);
+                    return;
+                }
+            }
+        }
+    }, [](size_t, size_t) {});
+    return data + found.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,502 @@
+#include "vector.h"
+#include "small_vector.h"
+
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <new>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Рандомизированная проверка безопасности исключений Vector и SmallVector. Входные байты задают
+// последовательность операций над парой векторов и для каждой операции — номер точки, в которой
+// бросается исключение: ею может быть любой конструктор или присваивание элемента и любое выделение
+// памяти. После каждой операции проверяются живость элементов, совпадение с эталонным std::vector
+// и число живых объектов, а после уничтожения векторов — отсутствие утечек памяти.
+//
+// С libFuzzer:
+//   clang++ -std=c++17 -g -O1 -fsanitize=fuzzer,address,undefined -DVECTOR_LIBFUZZER vector_fuzz.cpp
+// Без libFuzzer прогоняет заданное число случайных входов или воспроизводит входы из файлов:
+//   g++ -std=c++17 -g -fsanitize=address,undefined vector_fuzz.cpp -o vector_fuzz
+//   ./vector_fuzz [число входов] [seed]
+//   ./vector_fuzz crash-file...
+
+namespace {
+
+[[noreturn]] void Fail(const char* message) {
+    std::fprintf(stderr, "vector_fuzz: %s\n", message);
+    std::abort();
+}
+
+// В отличие от assert, проверка работает и при NDEBUG
+void Require(bool condition, const char* message) {
+    if (!condition) {
+        Fail(message);
+    }
+}
+
+struct InjectedFailure : std::exception {
+    const char* what() const noexcept override {
+        return "Injected failure";
+    }
+};
+
+// Состояние текущего прогона
+struct FuzzState {
+    // Число точек отказа до исключения. 0 означает, что исключения не бросаются
+    size_t throw_countdown = 0;
+    size_t alive_objects = 0;
+    size_t allocated_blocks = 0;
+};
+
+FuzzState state;
+
+// Точка отказа: бросает исключение, когда счётчик доходит до нуля
+template <typename Exception>
+void MaybeThrow() {
+    if (state.throw_countdown != 0 && --state.throw_countdown == 0) {
+        throw Exception();
+    }
+}
+
+enum class MoveKind {
+    // Перемещение может бросить исключение, поэтому вектор переносит элементы копированием
+    THROWING,
+    NOTHROW,
+    // Элементы переносятся побайтово через IsTriviallyRelocatable
+    RELOCATABLE,
+};
+
+inline constexpr uint32_t ALIVE_COOKIE = 0xdeadbeef;
+inline constexpr int MOVED_FROM = -1;
+
+template <MoveKind Kind>
+struct FuzzObj {
+    static constexpr bool IS_NOTHROW_MOVE = Kind != MoveKind::THROWING;
+
+    FuzzObj() {
+        MaybeThrow<InjectedFailure>();
+        Construct(0);
+    }
+
+    explicit FuzzObj(int value) {
+        MaybeThrow<InjectedFailure>();
+        Construct(value);
+    }
+
+    FuzzObj(const FuzzObj& other) {
+        other.CheckAlive();
+        MaybeThrow<InjectedFailure>();
+        Construct(other.id);
+    }
+
+    FuzzObj(FuzzObj&& other) noexcept(IS_NOTHROW_MOVE) {
+        other.CheckAlive();
+        if constexpr (!IS_NOTHROW_MOVE) {
+            MaybeThrow<InjectedFailure>();
+        }
+        Construct(std::exchange(other.id, MOVED_FROM));
+    }
+
+    FuzzObj& operator=(const FuzzObj& rhs) {
+        CheckAlive();
+        rhs.CheckAlive();
+        MaybeThrow<InjectedFailure>();
+        id = rhs.id;
+        return *this;
+    }
+
+    FuzzObj& operator=(FuzzObj&& rhs) noexcept(IS_NOTHROW_MOVE) {
+        CheckAlive();
+        rhs.CheckAlive();
+        if constexpr (!IS_NOTHROW_MOVE) {
+            MaybeThrow<InjectedFailure>();
+        }
+        id = std::exchange(rhs.id, MOVED_FROM);
+        return *this;
+    }
+
+    ~FuzzObj() {
+        CheckAlive();
+        cookie = 0;
+        --state.alive_objects;
+    }
+
+    void CheckAlive() const {
+        Require(cookie == ALIVE_COOKIE, "Access to a dead element");
+    }
+
+    int id = 0;
+    uint32_t cookie = 0;
+
+private:
+    void Construct(int value) {
+        id = value;
+        cookie = ALIVE_COOKIE;
+        ++state.alive_objects;
+    }
+};
+
+// Аллокатор, в котором каждое выделение памяти — точка отказа
+template <typename T>
+struct FuzzAllocator {
+    using value_type = T;
+
+    FuzzAllocator() = default;
+
+    template <typename U>
+    FuzzAllocator(const FuzzAllocator<U>&) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        MaybeThrow<std::bad_alloc>();
+        T* result = std::allocator<T>().allocate(n);
+        ++state.allocated_blocks;
+        return result;
+    }
+
+    void deallocate(T* ptr, size_t n) noexcept {
+        --state.allocated_blocks;
+        std::allocator<T>().deallocate(ptr, n);
+    }
+
+    friend bool operator==(const FuzzAllocator&, const FuzzAllocator&) noexcept {
+        return true;
+    }
+
+    friend bool operator!=(const FuzzAllocator&, const FuzzAllocator&) noexcept {
+        return false;
+    }
+};
+
+}  // namespace
+
+template <>
+struct IsTriviallyRelocatable<FuzzObj<MoveKind::RELOCATABLE>> : std::true_type {};
+
+namespace {
+
+// Читает байты входа; за концом входа возвращает нули
+class FuzzInput {
+public:
+    FuzzInput(const uint8_t* data, size_t size)
+        : data_(data)
+        , size_(size) {
+    }
+
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    uint8_t Next() noexcept {
+        if (size_ == 0) {
+            return 0;
+        }
+        --size_;
+        return *data_++;
+    }
+
+    // Число из [0, bound)
+    size_t NextBelow(size_t bound) noexcept {
+        return bound == 0 ? 0 : Next() % bound;
+    }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+};
+
+// Выполняет операции входа над двумя векторами VectorType и их эталонами
+template <typename VectorType>
+class FuzzRunner {
+    using Obj = typename VectorType::allocator_type::value_type;
+    using Model = std::vector<int>;
+
+public:
+    void Run(FuzzInput& input) {
+        while (!input.IsEmpty()) {
+            const uint8_t code = input.Next();
+            // Половина операций выполняется без исключений, остальные — с отказом в одной из первых 128 точек
+            const uint8_t failure = input.Next();
+            const size_t countdown = failure < 128 ? 0 : failure - 127;
+            RunOperation(code >> 1, code & 1, countdown, input);
+            Check();
+        }
+    }
+
+private:
+    VectorType vectors_[2];
+    Model models_[2];
+    int next_id_ = 1;
+
+    void RunOperation(size_t operation, size_t target, size_t countdown, FuzzInput& input) {
+        VectorType& v = vectors_[target];
+        Model& m = models_[target];
+        VectorType& other = vectors_[1 - target];
+        Model& other_model = models_[1 - target];
+        const size_t pos = input.NextBelow(v.Size() + 1);
+        const size_t count = input.NextBelow(8);
+        const int id = next_id_++;
+        // Аргументы создаются до включения отказов
+        const Obj value(id);
+        std::vector<Obj> batch;
+        Model batch_ids;
+        for (size_t i = 0; i != count; ++i) {
+            batch.emplace_back(id + static_cast<int>(i) * 1000);
+            batch_ids.push_back(id + static_cast<int>(i) * 1000);
+        }
+        Obj temp(id);
+
+        switch (operation % 27) {
+            case 0:
+                Apply(countdown, true, [&] { v.PushBack(value); }, [&] { m.push_back(id); });
+                break;
+            case 1:
+                Apply(countdown, true, [&] { v.PushBack(std::move(temp)); }, [&] { m.push_back(id); });
+                break;
+            case 2:
+                Apply(countdown, true, [&] { v.EmplaceBack(id); }, [&] { m.push_back(id); });
+                break;
+            case 3:
+                // Аргумент ссылается на элемент самого вектора
+                if (pos < v.Size()) {
+                    Apply(countdown, true, [&] { v.PushBack(v[pos]); }, [&] { m.push_back(m[pos]); });
+                }
+                break;
+            case 4:
+                Apply(countdown, false, [&] { v.Emplace(v.cbegin() + pos, id); },
+                      [&] { m.insert(m.begin() + pos, id); });
+                break;
+            case 5:
+                if (pos < v.Size()) {
+                    const size_t to = input.NextBelow(v.Size() + 1);
+                    Apply(countdown, false, [&] { v.Insert(v.cbegin() + to, v[pos]); },
+                          [&] { m.insert(m.begin() + to, m[pos]); });
+                }
+                break;
+            case 6:
+                Apply(countdown, false, [&] { v.Insert(v.cbegin() + pos, count, value); },
+                      [&] { m.insert(m.begin() + pos, count, id); });
+                break;
+            case 7:
+                Apply(countdown, false, [&] { v.Insert(v.cbegin() + pos, batch.begin(), batch.end()); },
+                      [&] { m.insert(m.begin() + pos, batch_ids.begin(), batch_ids.end()); });
+                break;
+            case 8:
+                if (pos < v.Size()) {
+                    Apply(countdown, false, [&] { v.Erase(v.cbegin() + pos); }, [&] { m.erase(m.begin() + pos); });
+                }
+                break;
+            case 9: {
+                const size_t last = pos + input.NextBelow(v.Size() - pos + 1);
+                Apply(countdown, false, [&] { v.Erase(v.cbegin() + pos, v.cbegin() + last); },
+                      [&] { m.erase(m.begin() + pos, m.begin() + last); });
+                break;
+            }
+            case 10:
+                if (pos < v.Size()) {
+                    Apply(countdown, false, [&] { v.SwapErase(v.cbegin() + pos); }, [&] {
+                        m[pos] = m.back();
+                        m.pop_back();
+                    });
+                }
+                break;
+            case 11:
+                if (v.Size() != 0) {
+                    Apply(countdown, true, [&] { v.PopBack(); }, [&] { m.pop_back(); });
+                }
+                break;
+            case 12: {
+                const size_t new_size = input.NextBelow(24);
+                Apply(countdown, true, [&] { v.Resize(new_size); }, [&] { m.resize(new_size); });
+                break;
+            }
+            case 13: {
+                const size_t new_size = input.NextBelow(24);
+                Apply(countdown, true, [&] { v.ResizeDefaultInit(new_size); }, [&] { m.resize(new_size); });
+                break;
+            }
+            case 14: {
+                const size_t new_capacity = input.NextBelow(40);
+                Apply(countdown, true, [&] { v.Reserve(new_capacity); }, [] {});
+                break;
+            }
+            case 15:
+                Apply(countdown, true, [&] { v.ShrinkToFit(); }, [] {});
+                break;
+            case 16:
+                Apply(countdown, true, [&] { v.Clear(); }, [&] { m.clear(); });
+                break;
+            case 17:
+                Apply(countdown, false, [&] { v.Assign(count, value); }, [&] { m.assign(count, id); });
+                break;
+            case 18:
+                Apply(countdown, false, [&] { v = other; }, [&] { m = other_model; });
+                break;
+            case 19:
+                Apply(countdown, false, [&] { v = std::move(other); }, [&] {
+                    m = std::move(other_model);
+                    other_model.clear();
+                });
+                break;
+            case 20:
+                Apply(countdown, false, [&] { v.Swap(other); }, [&] { m.swap(other_model); });
+                break;
+            case 21:
+                Apply(countdown, false, [&] {
+                    VectorType copy(other);
+                    v = std::move(copy);
+                }, [&] { m = other_model; });
+                break;
+            case 22:
+                Apply(countdown, false, [&] { v.Recycle(std::move(other)); }, [&] {
+                    m = std::move(other_model);
+                    other_model.clear();
+                });
+                break;
+            case 23: {
+                // Нехватка памяти сообщается результатом, а исключение конструктора выходит наружу
+                bool is_added = false;
+                Apply(countdown, true, [&] { is_added = v.TryPushBack(value); }, [&] {
+                    if (is_added) {
+                        m.push_back(id);
+                    }
+                });
+                break;
+            }
+            case 24:
+                Apply(countdown, false, [&] { v.Append(batch.begin(), batch.end()); },
+                      [&] { m.insert(m.end(), batch_ids.begin(), batch_ids.end()); });
+                break;
+            case 25:
+                Apply(countdown, false, [&] { v.Assign(batch.begin(), batch.end()); }, [&] { m = batch_ids; });
+                break;
+            case 26:
+                Apply(countdown, false, [&] { EraseIf(v, [](const Obj& obj) { return obj.id % 2 == 0; }); }, [&] {
+                    m.erase(std::remove_if(m.begin(), m.end(), [](int value) { return value % 2 == 0; }), m.end());
+                });
+                break;
+        }
+    }
+
+    // Выполняет операцию с отказом в точке countdown. При успехе эталон изменяется так же.
+    // При отказе операция со строгой гарантией не должна менять вектор, а в остальных случаях
+    // достаточно базовой гарантии: эталон принимает состояние векторов
+    template <typename Operation, typename ModelOperation>
+    void Apply(size_t countdown, bool is_strong, Operation operation, ModelOperation model_operation) {
+        bool is_failed = false;
+        state.throw_countdown = countdown;
+        try {
+            operation();
+        } catch (const InjectedFailure&) {
+            is_failed = true;
+        } catch (const std::bad_alloc&) {
+            is_failed = true;
+        } catch (...) {
+            Fail("Unexpected exception");
+        }
+        state.throw_countdown = 0;
+        if (!is_failed) {
+            model_operation();
+        } else if (!is_strong) {
+            for (size_t i = 0; i != 2; ++i) {
+                CheckInvariants(vectors_[i]);
+                models_[i].assign(vectors_[i].Size(), 0);
+                for (size_t j = 0; j != vectors_[i].Size(); ++j) {
+                    models_[i][j] = vectors_[i][j].id;
+                }
+            }
+        }
+    }
+
+    static void CheckInvariants(const VectorType& v) {
+        Require(v.Size() <= v.Capacity(), "Size exceeds capacity");
+        Require(v.Size() == 0 || v.Data() != nullptr, "Elements without memory");
+        for (const Obj& obj : v) {
+            obj.CheckAlive();
+        }
+    }
+
+    void Check() const {
+        size_t total_size = 0;
+        for (size_t i = 0; i != 2; ++i) {
+            CheckInvariants(vectors_[i]);
+            Require(vectors_[i].Size() == models_[i].size(), "Size differs from std::vector");
+            for (size_t j = 0; j != models_[i].size(); ++j) {
+                Require(vectors_[i][j].id == models_[i][j], "Element differs from std::vector");
+            }
+            total_size += vectors_[i].Size();
+        }
+        Require(state.alive_objects == total_size, "Elements leaked or destroyed twice");
+    }
+};
+
+template <typename VectorType>
+void RunInput(const uint8_t* data, size_t size) {
+    state = FuzzState{};
+    {
+        FuzzInput input(data, size);
+        FuzzRunner<VectorType> runner;
+        runner.Run(input);
+    }
+    Require(state.alive_objects == 0, "Elements leaked");
+    Require(state.allocated_blocks == 0, "Memory leaked");
+}
+
+template <MoveKind Kind>
+void RunInputForKind(const uint8_t* data, size_t size) {
+    using Obj = FuzzObj<Kind>;
+    RunInput<Vector<Obj, FuzzAllocator<Obj>>>(data, size);
+    RunInput<SmallVector<Obj, 3, FuzzAllocator<Obj>>>(data, size);
+}
+
+void RunAll(const uint8_t* data, size_t size) {
+    RunInputForKind<MoveKind::THROWING>(data, size);
+    RunInputForKind<MoveKind::NOTHROW>(data, size);
+    RunInputForKind<MoveKind::RELOCATABLE>(data, size);
+}
+
+}  // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    RunAll(data, size);
+    return 0;
+}
+
+#if !defined(VECTOR_LIBFUZZER)
+
+int main(int argc, char** argv) {
+    if (argc > 1 && !std::isdigit(static_cast<unsigned char>(argv[1][0]))) {
+        for (int i = 1; i < argc; ++i) {
+            std::ifstream file(argv[i], std::ios::binary);
+            Require(file.is_open(), "Cannot open input file");
+            const std::string bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            RunAll(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size());
+        }
+        std::printf("vector_fuzz: %d inputs passed\n", argc - 1);
+        return 0;
+    }
+    const unsigned long count = argc > 1 ? std::stoul(argv[1]) : 10000;
+    std::mt19937 generator(argc > 2 ? static_cast<unsigned>(std::stoul(argv[2])) : 1u);
+    std::uniform_int_distribution<size_t> length(0, 512);
+    std::uniform_int_distribution<int> byte(0, 255);
+    std::vector<uint8_t> data;
+    for (unsigned long i = 0; i != count; ++i) {
+        data.resize(length(generator));
+        for (uint8_t& value : data) {
+            value = static_cast<uint8_t>(byte(generator));
+        }
+        RunAll(data.data(), data.size());
+    }
+    std::printf("vector_fuzz: %lu inputs passed\n", count);
+    return 0;
+}
+
+#endif
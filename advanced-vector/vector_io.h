@@ -0,0 +1,220 @@
+#pragma once
+#include "vector.h"
+#include "segmented_vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+
+#include <sys/uio.h>
+#include <unistd.h>
+
+#if defined(VECTOR_USE_IO_URING)
+#include <liburing.h>
+#endif
+
+// Двоичный ввод-вывод векторов тривиально копируемых элементов через файловые дескрипторы.
+// Элементы записываются и читаются как есть, без преобразования порядка байт и выравнивания
+
+// Записывает count элементов целиком, повторяя write после частичной записи и прерывания сигналом
+template <typename T>
+void WriteTo(int fd, const T* data, size_t count) {
+    static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable elements can be written as bytes");
+    const char* bytes = reinterpret_cast<const char*>(data);
+    size_t remaining = count * sizeof(T);
+    while (remaining != 0) {
+        const ssize_t written = write(fd, bytes, remaining);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            VECTOR_THROW(std::system_error(errno, std::generic_category(), "write failed"));
+        }
+        bytes += written;
+        remaining -= static_cast<size_t>(written);
+    }
+}
+
+// Записывает элементы любого контейнера с непрерывным хранением (Vector, StaticVector, MappedVector...)
+template <typename Container>
+void WriteTo(int fd, const Container& container) {
+    WriteTo(fd, container.Data(), container.Size());
+}
+
+// Дописывает в конец vector до count элементов, прочитанных из fd, и возвращает их число. Байты
+// читаются прямо в неинициализированный хвост вектора через ResizeAndOverwrite, без промежуточного
+// буфера. Чтение прекращается раньше в конце файла; если файл обрывается посреди элемента,
+// целые элементы остаются в векторе, а об обрыве сообщает исключение
+template <typename T, typename Storage, typename GrowthPolicy, typename Stats>
+size_t ReadFrom(int fd, BasicVector<T, Storage, GrowthPolicy, Stats>& vector, size_t count) {
+    static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable elements can be read as bytes");
+    const size_t old_size = vector.Size();
+    size_t bytes_read = 0;
+    vector.ResizeAndOverwrite(old_size + count, [fd, old_size, count, &bytes_read](T* data, size_t) {
+        char* bytes = reinterpret_cast<char*>(data + old_size);
+        const size_t total = count * sizeof(T);
+        while (bytes_read != total) {
+            const ssize_t result = read(fd, bytes + bytes_read, total - bytes_read);
+            if (result < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                VECTOR_THROW(std::system_error(errno, std::generic_category(), "read failed"));
+            }
+            if (result == 0) {
+                break;
+            }
+            bytes_read += static_cast<size_t>(result);
+        }
+        return old_size + bytes_read / sizeof(T);
+    });
+    if (bytes_read % sizeof(T) != 0) {
+        VECTOR_THROW(std::runtime_error("Input ends in the middle of an element"));
+    }
+    return bytes_read / sizeof(T);
+}
+
+// Набор участков памяти, записываемых за один системный вызов writev. Участки ссылаются на данные
+// контейнеров без копирования, поэтому контейнеры не должны меняться до окончания записи
+class IoVector {
+public:
+    template <typename T>
+    void Add(const T* data, size_t count) {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable elements can be written as bytes");
+        if (count != 0) {
+            slices_.PushBack(iovec{const_cast<T*>(data), count * sizeof(T)});
+            bytes_ += count * sizeof(T);
+        }
+    }
+
+    template <typename Container>
+    void Add(const Container& container) {
+        Add(container.Data(), container.Size());
+    }
+
+    // Каждый блок SegmentedVector становится отдельным участком
+    template <typename T, size_t ChunkSize, typename Allocator>
+    void Add(const SegmentedVector<T, ChunkSize, Allocator>& vector) {
+        for (size_t first = 0; first < vector.Size(); first += ChunkSize) {
+            Add(&vector[first], std::min(ChunkSize, vector.Size() - first));
+        }
+    }
+
+    size_t Size() const noexcept {
+        return slices_.Size();
+    }
+
+    // Суммарный размер участков в байтах
+    size_t GetBytes() const noexcept {
+        return bytes_;
+    }
+
+    void Clear() noexcept {
+        slices_.Clear();
+        bytes_ = 0;
+    }
+
+    // Записывает все участки по порядку. Участки передаются пачками не длиннее IOV_MAX,
+    // а после частичной записи продолжается с первого недописанного байта
+    void WriteTo(int fd) const {
+        size_t index = 0;
+        size_t offset = 0;
+        while (index != slices_.Size()) {
+            iovec batch[BATCH_SIZE];
+            size_t batch_size = 0;
+            for (size_t i = index; i != slices_.Size() && batch_size != BATCH_SIZE; ++i, ++batch_size) {
+                batch[batch_size] = slices_[i];
+            }
+            batch[0].iov_base = static_cast<char*>(batch[0].iov_base) + offset;
+            batch[0].iov_len -= offset;
+            ssize_t written = writev(fd, batch, static_cast<int>(batch_size));
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                VECTOR_THROW(std::system_error(errno, std::generic_category(), "writev failed"));
+            }
+            // Пропускает полностью записанные участки
+            while (index != slices_.Size() && static_cast<size_t>(written) >= slices_[index].iov_len - offset) {
+                written -= static_cast<ssize_t>(slices_[index].iov_len - offset);
+                offset = 0;
+                ++index;
+            }
+            offset += static_cast<size_t>(written);
+        }
+    }
+
+private:
+#if defined(IOV_MAX)
+    static constexpr size_t BATCH_SIZE = IOV_MAX < 1024 ? IOV_MAX : 1024;
+#else
+    static constexpr size_t BATCH_SIZE = 16;
+#endif
+
+    Vector<iovec> slices_;
+    size_t bytes_ = 0;
+};
+
+#if defined(VECTOR_USE_IO_URING)
+
+// Аналог ReadFrom для чтения со смещения offset через io_uring. Если buffer_index неотрицателен,
+// буфер вектора должен быть зарегистрирован в ring под этим индексом (io_uring_register_buffers)
+// и уже вмещать Size() + count элементов, чтобы чтение не реаллоцировало его. Тогда используется
+// read_fixed, и ядру не приходится закреплять страницы буфера при каждом запросе
+template <typename T, typename Storage, typename GrowthPolicy, typename Stats>
+size_t ReadFromAt(io_uring& ring, int fd, BasicVector<T, Storage, GrowthPolicy, Stats>& vector, size_t count,
+                  uint64_t offset, int buffer_index = -1) {
+    static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable elements can be read as bytes");
+    const size_t old_size = vector.Size();
+    assert(buffer_index < 0 || old_size + count <= vector.Capacity());
+    size_t bytes_read = 0;
+    vector.ResizeAndOverwrite(old_size + count, [&](T* data, size_t) {
+        char* bytes = reinterpret_cast<char*>(data + old_size);
+        const size_t total = count * sizeof(T);
+        while (bytes_read != total) {
+            io_uring_sqe* sqe = io_uring_get_sqe(&ring);
+            if (sqe == nullptr) {
+                VECTOR_THROW(std::runtime_error("io_uring submission queue is full"));
+            }
+            const unsigned length = static_cast<unsigned>(std::min<size_t>(total - bytes_read, UINT_MAX));
+            if (buffer_index >= 0) {
+                io_uring_prep_read_fixed(sqe, fd, bytes + bytes_read, length, offset + bytes_read, buffer_index);
+            } else {
+                io_uring_prep_read(sqe, fd, bytes + bytes_read, length, offset + bytes_read);
+            }
+            int result = io_uring_submit(&ring);
+            io_uring_cqe* cqe = nullptr;
+            if (result >= 0) {
+                result = io_uring_wait_cqe(&ring, &cqe);
+            }
+            if (result < 0) {
+                VECTOR_THROW(std::system_error(-result, std::generic_category(), "io_uring submission failed"));
+            }
+            result = cqe->res;
+            io_uring_cqe_seen(&ring, cqe);
+            if (result == -EINTR || result == -EAGAIN) {
+                continue;
+            }
+            if (result < 0) {
+                VECTOR_THROW(std::system_error(-result, std::generic_category(), "io_uring read failed"));
+            }
+            if (result == 0) {
+                break;
+            }
+            bytes_read += static_cast<size_t>(result);
+        }
+        return old_size + bytes_read / sizeof(T);
+    });
+    if (bytes_read % sizeof(T) != 0) {
+        VECTOR_THROW(std::runtime_error("Input ends in the middle of an element"));
+    }
+    return bytes_read / sizeof(T);
+}
+
+#endif
@@ -0,0 +1,200 @@
+#pragma once
+#include "vector.h"
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Снимок счётчиков одной группы векторов
+struct VectorStatsSnapshot {
+    std::string name;
+    size_t reallocations = 0;
+    size_t expansions = 0;
+    size_t bytes_relocated = 0;
+    size_t bytes_copied = 0;
+    size_t copy_fallbacks = 0;
+    size_t peak_capacity = 0;
+    size_t destroyed = 0;
+    // Сумма capacity - size по уничтоженным векторам
+    size_t wasted_elements = 0;
+};
+
+// Счётчики группы векторов. Обновляются атомарно, поэтому векторы одной группы
+// могут жить в разных потоках. Имя не копируется и должно жить не меньше счётчиков
+class VectorStats {
+public:
+    explicit VectorStats(std::string_view name) noexcept
+        : name_(name) {
+    }
+
+    VectorStats(const VectorStats&) = delete;
+    VectorStats& operator=(const VectorStats&) = delete;
+
+    void OnReallocate(size_t new_capacity) noexcept {
+        reallocations_.fetch_add(1, std::memory_order_relaxed);
+        UpdatePeak(new_capacity);
+    }
+
+    void OnExpand(size_t new_capacity) noexcept {
+        expansions_.fetch_add(1, std::memory_order_relaxed);
+        UpdatePeak(new_capacity);
+    }
+
+    void OnRelocate(size_t bytes) noexcept {
+        bytes_relocated_.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    void OnCopy(size_t bytes) noexcept {
+        bytes_copied_.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    void OnCopyFallback(size_t bytes) noexcept {
+        copy_fallbacks_.fetch_add(1, std::memory_order_relaxed);
+        bytes_copied_.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    void OnDestroy(size_t size, size_t capacity) noexcept {
+        destroyed_.fetch_add(1, std::memory_order_relaxed);
+        wasted_elements_.fetch_add(capacity - size, std::memory_order_relaxed);
+        UpdatePeak(capacity);
+    }
+
+    VectorStatsSnapshot GetSnapshot() const {
+        VectorStatsSnapshot snapshot;
+        snapshot.name = std::string(name_);
+        snapshot.reallocations = reallocations_.load(std::memory_order_relaxed);
+        snapshot.expansions = expansions_.load(std::memory_order_relaxed);
+        snapshot.bytes_relocated = bytes_relocated_.load(std::memory_order_relaxed);
+        snapshot.bytes_copied = bytes_copied_.load(std::memory_order_relaxed);
+        snapshot.copy_fallbacks = copy_fallbacks_.load(std::memory_order_relaxed);
+        snapshot.peak_capacity = peak_capacity_.load(std::memory_order_relaxed);
+        snapshot.destroyed = destroyed_.load(std::memory_order_relaxed);
+        snapshot.wasted_elements = wasted_elements_.load(std::memory_order_relaxed);
+        return snapshot;
+    }
+
+    void Reset() noexcept {
+        reallocations_.store(0, std::memory_order_relaxed);
+        expansions_.store(0, std::memory_order_relaxed);
+        bytes_relocated_.store(0, std::memory_order_relaxed);
+        bytes_copied_.store(0, std::memory_order_relaxed);
+        copy_fallbacks_.store(0, std::memory_order_relaxed);
+        peak_capacity_.store(0, std::memory_order_relaxed);
+        destroyed_.store(0, std::memory_order_relaxed);
+        wasted_elements_.store(0, std::memory_order_relaxed);
+    }
+
+    std::string_view GetName() const noexcept {
+        return name_;
+    }
+
+private:
+    friend class VectorStatsRegistry;
+
+    void UpdatePeak(size_t capacity) noexcept {
+        size_t peak = peak_capacity_.load(std::memory_order_relaxed);
+        while (capacity > peak && !peak_capacity_.compare_exchange_weak(peak, capacity, std::memory_order_relaxed)) {
+        }
+    }
+
+    std::string_view name_;
+    // Следующие счётчики в списке реестра
+    VectorStats* next_ = nullptr;
+    std::atomic<size_t> reallocations_{0};
+    std::atomic<size_t> expansions_{0};
+    std::atomic<size_t> bytes_relocated_{0};
+    std::atomic<size_t> bytes_copied_{0};
+    std::atomic<size_t> copy_fallbacks_{0};
+    std::atomic<size_t> peak_capacity_{0};
+    std::atomic<size_t> destroyed_{0};
+    std::atomic<size_t> wasted_elements_{0};
+};
+
+// Глобальный реестр счётчиков, из которого их можно выгрузить одним вызовом GetSnapshots.
+// Счётчики образуют односвязный список, в который только добавляются элементы, поэтому регистрация
+// не выделяет памяти и не блокирует потоки, а обход не мешает одновременной регистрации
+class VectorStatsRegistry {
+public:
+    static VectorStatsRegistry& Instance() noexcept {
+        static VectorStatsRegistry registry;
+        return registry;
+    }
+
+    VectorStatsRegistry(const VectorStatsRegistry&) = delete;
+    VectorStatsRegistry& operator=(const VectorStatsRegistry&) = delete;
+
+    // Счётчики должны существовать до завершения программы и регистрироваться один раз
+    void Register(VectorStats& stats) noexcept {
+        VectorStats* head = head_.load(std::memory_order_relaxed);
+        do {
+            stats.next_ = head;
+        } while (!head_.compare_exchange_weak(head, &stats, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    // Снимки идут от последних зарегистрированных счётчиков к первым
+    std::vector<VectorStatsSnapshot> GetSnapshots() const {
+        std::vector<VectorStatsSnapshot> snapshots;
+        for (const VectorStats* stats = head_.load(std::memory_order_acquire); stats != nullptr; stats = stats->next_) {
+            snapshots.push_back(stats->GetSnapshot());
+        }
+        return snapshots;
+    }
+
+    void ResetAll() noexcept {
+        for (VectorStats* stats = head_.load(std::memory_order_acquire); stats != nullptr; stats = stats->next_) {
+            stats->Reset();
+        }
+    }
+
+private:
+    VectorStatsRegistry() = default;
+
+    std::atomic<VectorStats*> head_{nullptr};
+};
+
+// Политика сбора статистики для Vector. Все векторы с одинаковым Tag пишут в общие счётчики,
+// которые регистрируются в VectorStatsRegistry под именем Tag::NAME при первом событии.
+// Первое обращение не выделяет памяти, поэтому noexcept-обработчики не могут завершить программу
+// из-за std::bad_alloc.
+// Обычно Tag объявляется рядом с местом использования вектора:
+//   struct RequestBufferTag { static constexpr std::string_view NAME = "request_buffer"; };
+//   Vector<char, std::allocator<char>, DoublingGrowth, CountingStats<RequestBufferTag>> buffer;
+template <typename Tag>
+struct CountingStats {
+    static VectorStats& Get() noexcept {
+        static VectorStats& stats = Register();
+        return stats;
+    }
+
+    static void OnReallocate(size_t /*old_capacity*/, size_t new_capacity) noexcept {
+        Get().OnReallocate(new_capacity);
+    }
+    static void OnExpand(size_t /*old_capacity*/, size_t new_capacity) noexcept {
+        Get().OnExpand(new_capacity);
+    }
+    static void OnRelocate(size_t bytes) noexcept {
+        Get().OnRelocate(bytes);
+    }
+    static void OnCopy(size_t bytes) noexcept {
+        Get().OnCopy(bytes);
+    }
+    static void OnCopyFallback(size_t bytes) noexcept {
+        Get().OnCopyFallback(bytes);
+    }
+    static void OnDestroy(size_t size, size_t capacity) noexcept {
+        Get().OnDestroy(size, capacity);
+    }
+
+private:
+    // Счётчики создаются в статическом буфере и не уничтожаются, чтобы векторы в статических
+    // объектах могли обращаться к ним до самого завершения программы
+    static VectorStats& Register() noexcept {
+        alignas(VectorStats) static unsigned char storage[sizeof(VectorStats)];
+        VectorStats* stats = new (storage) VectorStats(Tag::NAME);
+        VectorStatsRegistry::Instance().Register(*stats);
+        return *stats;
+    }
+};